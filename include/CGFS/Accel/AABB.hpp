@@ -0,0 +1,109 @@
+/**
+ * @brief Axis aligned bounding boxes and the ray slab test
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_AABB_HPP
+#define CGFS_AABB_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+
+#include <algorithm>
+
+namespace cgfs {
+
+using AABB = mguid::NamedTuple<mguid::NamedType<"min", Vec3d>, mguid::NamedType<"max", Vec3d>>;
+
+constexpr AABB empty_aabb() {
+  return AABB{Vec3d{basically_infinity, basically_infinity, basically_infinity},
+              Vec3d{-basically_infinity, -basically_infinity, -basically_infinity}};
+}
+
+constexpr Vec3d component_min(const Vec3d& a, const Vec3d& b) {
+  return Vec3d{std::min(a.get<"x">(), b.get<"x">()), std::min(a.get<"y">(), b.get<"y">()),
+               std::min(a.get<"z">(), b.get<"z">())};
+}
+
+constexpr Vec3d component_max(const Vec3d& a, const Vec3d& b) {
+  return Vec3d{std::max(a.get<"x">(), b.get<"x">()), std::max(a.get<"y">(), b.get<"y">()),
+               std::max(a.get<"z">(), b.get<"z">())};
+}
+
+constexpr AABB merge(const AABB& a, const AABB& b) {
+  return AABB{component_min(a.get<"min">(), b.get<"min">()),
+              component_max(a.get<"max">(), b.get<"max">())};
+}
+
+constexpr AABB merge(const AABB& a, const Vec3d& point) {
+  return AABB{component_min(a.get<"min">(), point), component_max(a.get<"max">(), point)};
+}
+
+constexpr Vec3d centroid(const AABB& box) {
+  return 0.5 * (box.get<"min">() + box.get<"max">());
+}
+
+constexpr double surface_area(const AABB& box) {
+  const auto extent = box.get<"max">() - box.get<"min">();
+  const double x = std::max(extent.get<"x">(), 0.0);
+  const double y = std::max(extent.get<"y">(), 0.0);
+  const double z = std::max(extent.get<"z">(), 0.0);
+  return 2.0 * (x * y + y * z + z * x);
+}
+
+constexpr bool contains(const AABB& box, const Vec3d& point) {
+  const auto& lo = box.get<"min">();
+  const auto& hi = box.get<"max">();
+  return lo.get<"x">() <= point.get<"x">() && point.get<"x">() <= hi.get<"x">() &&
+         lo.get<"y">() <= point.get<"y">() && point.get<"y">() <= hi.get<"y">() &&
+         lo.get<"z">() <= point.get<"z">() && point.get<"z">() <= hi.get<"z">();
+}
+
+constexpr AABB bounds_of(const Sphere& sphere) {
+  const auto& center = sphere.get<"center">();
+  const double r = sphere.get<"radius">();
+  return AABB{center - Vec3d{r, r, r}, center + Vec3d{r, r, r}};
+}
+
+/**
+ * @brief Slab test of a ray against a box
+ * @param box box to test
+ * @param origin ray origin
+ * @param inv_direction component-wise reciprocal of the ray direction
+ * @param t_min lower end of the ray interval
+ * @param t_max upper end of the ray interval
+ * @return parametric distance where the ray enters the box, or basically_infinity on a miss
+ */
+constexpr double intersect_ray_aabb(const AABB& box, const Origin& origin,
+                                    const Vec3d& inv_direction, double t_min, double t_max) {
+  const auto& box_min = box.get<"min">();
+  const auto& box_max = box.get<"max">();
+
+  const double tx1 = (box_min.get<"x">() - origin.get<"x">()) * inv_direction.get<"x">();
+  const double tx2 = (box_max.get<"x">() - origin.get<"x">()) * inv_direction.get<"x">();
+  const double ty1 = (box_min.get<"y">() - origin.get<"y">()) * inv_direction.get<"y">();
+  const double ty2 = (box_max.get<"y">() - origin.get<"y">()) * inv_direction.get<"y">();
+  const double tz1 = (box_min.get<"z">() - origin.get<"z">()) * inv_direction.get<"z">();
+  const double tz2 = (box_max.get<"z">() - origin.get<"z">()) * inv_direction.get<"z">();
+
+  // std::max/std::min return their first argument when the second is NaN, so keeping the running
+  // interval first makes a 0 * inf slab (ray lying in a box face) leave the interval unchanged
+  const double t_enter = std::max(
+      std::max(std::max(t_min, std::min(tx1, tx2)), std::min(ty1, ty2)), std::min(tz1, tz2));
+  const double t_exit = std::min(
+      std::min(std::min(t_max, std::max(tx1, tx2)), std::max(ty1, ty2)), std::max(tz1, tz2));
+
+  return t_enter <= t_exit ? t_enter : basically_infinity;
+}
+
+constexpr Vec3d reciprocal(const Vec3d& direction) {
+  return Vec3d{1.0 / direction.get<"x">(), 1.0 / direction.get<"y">(), 1.0 / direction.get<"z">()};
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_AABB_HPP
@@ -0,0 +1,287 @@
+/**
+ * @brief Bounding volume hierarchy built with a binned SAH
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_BVH_HPP
+#define CGFS_BVH_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <span>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief A flattened BVH node
+ *
+ * Nodes are stored depth first. An interior node (count == 0) has its left child directly after
+ * it and its right child at offset. A leaf covers primitives [offset, offset + count) of the
+ * primitive order the tree was built with.
+ */
+using BVHNode = mguid::NamedTuple<mguid::NamedType<"bounds", AABB>,
+                                  mguid::NamedType<"offset", uint32_t>,
+                                  mguid::NamedType<"count", uint32_t>>;
+
+class BVH {
+public:
+  static constexpr uint32_t max_leaf_size = 4;
+  static constexpr size_t bin_count = 16;
+  static constexpr size_t max_depth = 64;
+
+  BVH() = default;
+
+  /**
+   * @brief Build a hierarchy over a set of primitive bounds
+   *
+   * The builder never moves the caller's primitives, it only records an order. Callers store
+   * their primitives in primitive_order() so that leaves address contiguous ranges.
+   *
+   * @param primitive_bounds bounds of every primitive
+   */
+  explicit BVH(std::span<const AABB> primitive_bounds) {
+    m_order.resize(primitive_bounds.size());
+    std::iota(m_order.begin(), m_order.end(), uint32_t{0});
+    if (primitive_bounds.empty()) { return; }
+
+    std::vector<Vec3d> centroids;
+    centroids.reserve(primitive_bounds.size());
+    for (const auto& bounds : primitive_bounds) { centroids.push_back(centroid(bounds)); }
+
+    m_nodes.reserve(2 * primitive_bounds.size());
+    build(primitive_bounds, centroids, 0, static_cast<uint32_t>(primitive_bounds.size()), 0);
+  }
+
+  /**
+   * @brief Recompute every node's bounds for primitives that moved, keeping the topology
+   *
+   * Much cheaper than a rebuild, but the tree degrades as primitives drift from where it was
+   * built, so large edits are better served by constructing a new BVH.
+   *
+   * @param primitive_bounds bounds of every primitive, indexed like the constructor's input
+   */
+  void refit(std::span<const AABB> primitive_bounds) {
+    // Children always follow their parent, so a reverse sweep sees them first
+    for (size_t i{m_nodes.size()}; i-- > 0;) {
+      auto& node = m_nodes[i];
+      AABB bounds = empty_aabb();
+      if (node.get<"count">() != 0) {
+        for (uint32_t p{0}; p < node.get<"count">(); ++p) {
+          bounds = merge(bounds, primitive_bounds[m_order[node.get<"offset">() + p]]);
+        }
+      } else {
+        bounds = merge(m_nodes[i + 1].get<"bounds">(),
+                       m_nodes[node.get<"offset">()].get<"bounds">());
+      }
+      node.get<"bounds">() = bounds;
+    }
+  }
+
+  [[nodiscard]] bool empty() const { return m_nodes.empty(); }
+  [[nodiscard]] const std::vector<BVHNode>& nodes() const { return m_nodes; }
+  [[nodiscard]] const std::vector<uint32_t>& primitive_order() const { return m_order; }
+
+  /**
+   * @brief Walk every leaf the ray can reach, nearest child first
+   *
+   * visit_leaf(first, count) is called for each leaf whose box overlaps [t_min, t_max]. It may
+   * shrink t_max as closer hits are found, which prunes the remaining traversal, and returns
+   * true to stop the walk early.
+   *
+   * @param origin ray origin
+   * @param direction ray direction
+   * @param t_min lower end of the ray interval
+   * @param t_max upper end of the ray interval, updated by visit_leaf
+   * @param visit_leaf leaf callback
+   * @return true if visit_leaf stopped the traversal
+   */
+  template <typename LeafVisitor>
+  bool traverse(const Origin& origin, const Vec3d& direction, double t_min, double& t_max,
+                LeafVisitor&& visit_leaf) const {
+    const Vec3d inv_direction = reciprocal(direction);
+    return traverse_with(
+        [&](const AABB& bounds) {
+          return intersect_ray_aabb(bounds, origin, inv_direction, t_min, t_max);
+        },
+        visit_leaf);
+  }
+
+  /**
+   * @brief Walk the tree with a caller supplied box test, nearest child first
+   *
+   * box_test(bounds) returns the distance at which the query enters the box, or
+   * basically_infinity to cull it. This is how queries that are not a single ray, such as ray
+   * packets, share the traversal loop.
+   *
+   * @param box_test node culling test
+   * @param visit_leaf leaf callback, returns true to stop the walk
+   * @return true if visit_leaf stopped the traversal
+   */
+  template <typename BoxTest, typename LeafVisitor>
+  bool traverse_with(BoxTest&& box_test, LeafVisitor&& visit_leaf) const {
+    if (m_nodes.empty()) { return false; }
+
+    std::array<uint32_t, max_depth + 1> stack;
+    size_t stack_size = 0;
+
+    if (box_test(m_nodes.front().get<"bounds">()) == basically_infinity) { return false; }
+
+    uint32_t current = 0;
+    while (true) {
+      const BVHNode& node = m_nodes[current];
+
+      if (node.get<"count">() != 0) {
+        if (visit_leaf(node.get<"offset">(), node.get<"count">())) { return true; }
+      } else {
+        uint32_t near_child = current + 1;
+        uint32_t far_child = node.get<"offset">();
+
+        double t_near = box_test(m_nodes[near_child].get<"bounds">());
+        double t_far = box_test(m_nodes[far_child].get<"bounds">());
+
+        if (t_far < t_near) {
+          std::swap(near_child, far_child);
+          std::swap(t_near, t_far);
+        }
+
+        if (t_near != basically_infinity) {
+          if (t_far != basically_infinity) { stack[stack_size++] = far_child; }
+          current = near_child;
+          continue;
+        }
+      }
+
+      if (stack_size == 0) { return false; }
+      current = stack[--stack_size];
+    }
+  }
+
+private:
+  struct Bin {
+    AABB bounds{empty_aabb()};
+    uint32_t count{0};
+  };
+
+  uint32_t make_leaf(const AABB& bounds, uint32_t begin, uint32_t end) {
+    m_nodes.emplace_back(bounds, begin, end - begin);
+    return static_cast<uint32_t>(m_nodes.size() - 1);
+  }
+
+  uint32_t build(std::span<const AABB> primitive_bounds, const std::vector<Vec3d>& centroids,
+                 uint32_t begin, uint32_t end, size_t depth) {
+    AABB bounds = empty_aabb();
+    AABB centroid_bounds = empty_aabb();
+    for (uint32_t i{begin}; i < end; ++i) {
+      bounds = merge(bounds, primitive_bounds[m_order[i]]);
+      centroid_bounds = merge(centroid_bounds, centroids[m_order[i]]);
+    }
+
+    const uint32_t count = end - begin;
+    if (count <= max_leaf_size) { return make_leaf(bounds, begin, end); }
+
+    const auto extent = centroid_bounds.get<"max">() - centroid_bounds.get<"min">();
+    const std::array<double, 3> extents{extent.get<"x">(), extent.get<"y">(), extent.get<"z">()};
+    const auto axis = static_cast<size_t>(
+        std::distance(extents.begin(), std::max_element(extents.begin(), extents.end())));
+
+    // Every centroid coincides, no split can separate them
+    if (extents[axis] <= 0.0) { return make_leaf(bounds, begin, end); }
+
+    const double axis_min = component(centroid_bounds.get<"min">(), axis);
+    const double bin_scale = static_cast<double>(bin_count) / extents[axis];
+    const auto bin_of = [&](uint32_t primitive) {
+      const auto bin =
+          static_cast<size_t>((component(centroids[primitive], axis) - axis_min) * bin_scale);
+      return std::min(bin, bin_count - 1);
+    };
+
+    uint32_t mid = begin;
+
+    // Past half the depth budget fall back to median splits so the stack bound holds
+    if (depth < max_depth / 2) {
+      std::array<Bin, bin_count> bins{};
+      for (uint32_t i{begin}; i < end; ++i) {
+        auto& bin = bins[bin_of(m_order[i])];
+        bin.bounds = merge(bin.bounds, primitive_bounds[m_order[i]]);
+        ++bin.count;
+      }
+
+      // Sweep from the right to get the cost of every "right of split" side
+      std::array<double, bin_count> right_cost{};
+      AABB right_bounds = empty_aabb();
+      uint32_t right_count = 0;
+      for (size_t split = bin_count - 1; split > 0; --split) {
+        right_bounds = merge(right_bounds, bins[split].bounds);
+        right_count += bins[split].count;
+        right_cost[split] = right_count == 0 ? 0.0 : surface_area(right_bounds) * right_count;
+      }
+
+      double best_cost = std::numeric_limits<double>::max();
+      size_t best_split = 0;
+      AABB left_bounds = empty_aabb();
+      uint32_t left_count = 0;
+      for (size_t split = 1; split < bin_count; ++split) {
+        left_bounds = merge(left_bounds, bins[split - 1].bounds);
+        left_count += bins[split - 1].count;
+        if (left_count == 0 || left_count == count) { continue; }
+
+        const double cost = surface_area(left_bounds) * left_count + right_cost[split];
+        if (cost < best_cost) {
+          best_cost = cost;
+          best_split = split;
+        }
+      }
+
+      const double leaf_cost = surface_area(bounds) * count;
+      if (best_split != 0 && best_cost >= leaf_cost && count <= 2 * max_leaf_size) {
+        return make_leaf(bounds, begin, end);
+      }
+
+      if (best_split != 0) {
+        mid = static_cast<uint32_t>(
+            std::partition(m_order.begin() + begin, m_order.begin() + end,
+                           [&](uint32_t primitive) { return bin_of(primitive) < best_split; }) -
+            m_order.begin());
+      }
+    }
+
+    if (mid == begin || mid == end) {
+      mid = begin + count / 2;
+      std::nth_element(m_order.begin() + begin, m_order.begin() + mid, m_order.begin() + end,
+                       [&](uint32_t lhs, uint32_t rhs) {
+                         return component(centroids[lhs], axis) < component(centroids[rhs], axis);
+                       });
+    }
+
+    const auto node_index = static_cast<uint32_t>(m_nodes.size());
+    m_nodes.emplace_back(bounds, uint32_t{0}, uint32_t{0});
+
+    build(primitive_bounds, centroids, begin, mid, depth + 1);
+    const uint32_t right_child = build(primitive_bounds, centroids, mid, end, depth + 1);
+    m_nodes[node_index].get<"offset">() = right_child;
+
+    return node_index;
+  }
+
+  static constexpr double component(const Vec3d& vec, size_t axis) {
+    return axis == 0 ? vec.get<"x">() : (axis == 1 ? vec.get<"y">() : vec.get<"z">());
+  }
+
+  std::vector<BVHNode> m_nodes;
+  std::vector<uint32_t> m_order;
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_BVH_HPP
@@ -0,0 +1,737 @@
+/**
+ * @brief Structure-of-arrays sphere storage and SIMD ray-sphere kernels
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_SPHERE_SOA_HPP
+#define CGFS_SPHERE_SOA_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/AlignedAllocator.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CpuFeatures.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <type_traits>
+
+#if CGFS_SSE2_KERNELS || CGFS_AVX2_KERNELS || CGFS_AVX512_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace cgfs {
+
+template <typename Scalar>
+using BasicSphereHit =
+    mguid::NamedTuple<mguid::NamedType<"t", Scalar>, mguid::NamedType<"index", uint32_t>>;
+
+using SphereHit = BasicSphereHit<double>;
+using SphereHitF = BasicSphereHit<float>;
+
+constexpr uint32_t no_sphere = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Sphere geometry split into one aligned stream per component
+ *
+ * Every stream is padded with NaN centers past size() so a kernel may load a full vector
+ * starting at any valid index; padded lanes never produce a hit.
+ *
+ * The streams hold double or float. A float stream fits twice the spheres in a vector register
+ * and a cache line, at the cost of the precision of hit distances far from the origin.
+ */
+template <typename Scalar>
+class BasicSphereSoA {
+public:
+  /// Lanes of the widest vector kernel, 512 bits
+  static constexpr size_t max_lanes = 64 / sizeof(Scalar);
+
+  BasicSphereSoA() = default;
+
+  explicit BasicSphereSoA(std::span<const Sphere> spheres) : m_size{spheres.size()} {
+    const size_t padded = ((m_size + max_lanes - 1) / max_lanes) * max_lanes + max_lanes;
+    const Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+
+    m_center_x.assign(padded, nan);
+    m_center_y.assign(padded, nan);
+    m_center_z.assign(padded, nan);
+    m_radius.assign(padded, Scalar{0});
+    m_radius_sq.assign(padded, Scalar{0});
+
+    for (size_t i{0}; i < m_size; ++i) { set(i, spheres[i]); }
+  }
+
+  /**
+   * @brief Overwrite the geometry of sphere index in place
+   */
+  void set(size_t index, const Sphere& sphere) {
+    const auto& center = sphere.get<"center">();
+    const double radius = sphere.get<"radius">();
+    m_center_x[index] = static_cast<Scalar>(center.get<"x">());
+    m_center_y[index] = static_cast<Scalar>(center.get<"y">());
+    m_center_z[index] = static_cast<Scalar>(center.get<"z">());
+    m_radius[index] = static_cast<Scalar>(radius);
+    m_radius_sq[index] = static_cast<Scalar>(radius * radius);
+  }
+
+  [[nodiscard]] size_t size() const { return m_size; }
+  [[nodiscard]] const Scalar* center_x() const { return m_center_x.data(); }
+  [[nodiscard]] const Scalar* center_y() const { return m_center_y.data(); }
+  [[nodiscard]] const Scalar* center_z() const { return m_center_z.data(); }
+  [[nodiscard]] const Scalar* radius() const { return m_radius.data(); }
+  [[nodiscard]] const Scalar* radius_sq() const { return m_radius_sq.data(); }
+
+private:
+  size_t m_size{0};
+  AlignedVector<Scalar> m_center_x;
+  AlignedVector<Scalar> m_center_y;
+  AlignedVector<Scalar> m_center_z;
+  AlignedVector<Scalar> m_radius;
+  AlignedVector<Scalar> m_radius_sq;
+};
+
+using SphereSoA = BasicSphereSoA<double>;
+using SphereSoAF = BasicSphereSoA<float>;
+
+namespace detail {
+
+/**
+ * @brief Pick the nearest lane hit, preferring the lowest index on ties like the linear search
+ */
+template <typename Scalar>
+BasicSphereHit<Scalar> reduce_lanes(const Scalar* lane_t, const Scalar* lane_index,
+                                    size_t lanes) {
+  Scalar best_t = std::numeric_limits<Scalar>::infinity();
+  Scalar best_index = -1;
+  for (size_t lane{0}; lane < lanes; ++lane) {
+    if (lane_index[lane] < 0) { continue; }
+    if (lane_t[lane] < best_t || (lane_t[lane] == best_t && lane_index[lane] < best_index)) {
+      best_t = lane_t[lane];
+      best_index = lane_index[lane];
+    }
+  }
+  if (best_index < 0) {
+    return BasicSphereHit<Scalar>{static_cast<Scalar>(basically_infinity), no_sphere};
+  }
+  return BasicSphereHit<Scalar>{best_t, static_cast<uint32_t>(best_index)};
+}
+
+template <typename Scalar>
+BasicSphereHit<Scalar> intersect_spheres_scalar(const BasicSphereSoA<Scalar>& spheres,
+                                                const Vec3<Scalar>& origin,
+                                                const Vec3<Scalar>& direction, Scalar t_min,
+                                                Scalar t_max, uint32_t first, uint32_t last) {
+  const Scalar ox = origin.template get<"x">();
+  const Scalar oy = origin.template get<"y">();
+  const Scalar oz = origin.template get<"z">();
+  const Scalar dx = direction.template get<"x">();
+  const Scalar dy = direction.template get<"y">();
+  const Scalar dz = direction.template get<"z">();
+  const Scalar a = dx * dx + dy * dy + dz * dz;
+
+  Scalar best_t = t_max;
+  uint32_t best_index = no_sphere;
+
+  for (uint32_t i{first}; i < last; ++i) {
+    const Scalar cox = ox - spheres.center_x()[i];
+    const Scalar coy = oy - spheres.center_y()[i];
+    const Scalar coz = oz - spheres.center_z()[i];
+
+    const Scalar half_b = cox * dx + coy * dy + coz * dz;
+    const Scalar c = cox * cox + coy * coy + coz * coz - spheres.radius_sq()[i];
+    const Scalar discriminant = half_b * half_b - a * c;
+    if (!(discriminant >= 0)) { continue; }
+
+    const Scalar root = std::sqrt(discriminant);
+    const Scalar t_near = (-half_b - root) / a;
+    const Scalar t_far = (-half_b + root) / a;
+
+    if (t_near > t_min && t_near < best_t) {
+      best_t = t_near;
+      best_index = i;
+    } else if (t_far > t_min && t_far < best_t) {
+      best_t = t_far;
+      best_index = i;
+    }
+  }
+
+  return best_index == no_sphere
+             ? BasicSphereHit<Scalar>{static_cast<Scalar>(basically_infinity), no_sphere}
+             : BasicSphereHit<Scalar>{best_t, best_index};
+}
+
+#if CGFS_SSE2_KERNELS
+CGFS_TARGET("sse2")
+inline SphereHit intersect_spheres_sse2(const SphereSoA& spheres, const Origin& origin,
+                                        const Vec3d& direction, double t_min, double t_max,
+                                        uint32_t first, uint32_t last) {
+  const auto select = [](__m128d mask, __m128d if_true, __m128d if_false) {
+    return _mm_or_pd(_mm_and_pd(mask, if_true), _mm_andnot_pd(mask, if_false));
+  };
+
+  const double dx = direction.get<"x">();
+  const double dy = direction.get<"y">();
+  const double dz = direction.get<"z">();
+
+  const __m128d ox = _mm_set1_pd(origin.get<"x">());
+  const __m128d oy = _mm_set1_pd(origin.get<"y">());
+  const __m128d oz = _mm_set1_pd(origin.get<"z">());
+  const __m128d vdx = _mm_set1_pd(dx);
+  const __m128d vdy = _mm_set1_pd(dy);
+  const __m128d vdz = _mm_set1_pd(dz);
+  const __m128d a = _mm_set1_pd(dx * dx + dy * dy + dz * dz);
+  const __m128d v_t_min = _mm_set1_pd(t_min);
+  const __m128d zero = _mm_setzero_pd();
+  const __m128d v_last = _mm_set1_pd(static_cast<double>(last));
+  const __m128d lane_offsets = _mm_set_pd(1.0, 0.0);
+
+  __m128d best_t = _mm_set1_pd(t_max);
+  __m128d best_index = _mm_set1_pd(-1.0);
+
+  for (uint32_t i{first}; i < last; i += 2) {
+    const __m128d index = _mm_add_pd(_mm_set1_pd(static_cast<double>(i)), lane_offsets);
+
+    const __m128d cox = _mm_sub_pd(ox, _mm_loadu_pd(spheres.center_x() + i));
+    const __m128d coy = _mm_sub_pd(oy, _mm_loadu_pd(spheres.center_y() + i));
+    const __m128d coz = _mm_sub_pd(oz, _mm_loadu_pd(spheres.center_z() + i));
+
+    const __m128d half_b =
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(cox, vdx), _mm_mul_pd(coy, vdy)), _mm_mul_pd(coz, vdz));
+    const __m128d c = _mm_sub_pd(
+        _mm_add_pd(_mm_add_pd(_mm_mul_pd(cox, cox), _mm_mul_pd(coy, coy)), _mm_mul_pd(coz, coz)),
+        _mm_loadu_pd(spheres.radius_sq() + i));
+    const __m128d discriminant = _mm_sub_pd(_mm_mul_pd(half_b, half_b), _mm_mul_pd(a, c));
+
+    const __m128d hit = _mm_and_pd(_mm_cmplt_pd(index, v_last), _mm_cmpge_pd(discriminant, zero));
+    if (_mm_movemask_pd(hit) == 0) { continue; }
+
+    const __m128d root = _mm_sqrt_pd(_mm_max_pd(discriminant, zero));
+    const __m128d neg_b = _mm_sub_pd(zero, half_b);
+    const __m128d t_near = _mm_div_pd(_mm_sub_pd(neg_b, root), a);
+    const __m128d t_far = _mm_div_pd(_mm_add_pd(neg_b, root), a);
+
+    const __m128d near_ok = _mm_and_pd(
+        hit, _mm_and_pd(_mm_cmpgt_pd(t_near, v_t_min), _mm_cmplt_pd(t_near, best_t)));
+    const __m128d far_ok =
+        _mm_and_pd(hit, _mm_and_pd(_mm_cmpgt_pd(t_far, v_t_min), _mm_cmplt_pd(t_far, best_t)));
+    const __m128d ok = _mm_or_pd(near_ok, far_ok);
+
+    best_t = select(ok, select(near_ok, t_near, t_far), best_t);
+    best_index = select(ok, index, best_index);
+  }
+
+  alignas(16) double lane_t[2];
+  alignas(16) double lane_index[2];
+  _mm_store_pd(lane_t, best_t);
+  _mm_store_pd(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 2);
+}
+#endif
+
+#if CGFS_AVX2_KERNELS
+CGFS_TARGET("avx2")
+inline SphereHit intersect_spheres_avx2(const SphereSoA& spheres, const Origin& origin,
+                                        const Vec3d& direction, double t_min, double t_max,
+                                        uint32_t first, uint32_t last) {
+  const double dx = direction.get<"x">();
+  const double dy = direction.get<"y">();
+  const double dz = direction.get<"z">();
+
+  const __m256d ox = _mm256_set1_pd(origin.get<"x">());
+  const __m256d oy = _mm256_set1_pd(origin.get<"y">());
+  const __m256d oz = _mm256_set1_pd(origin.get<"z">());
+  const __m256d vdx = _mm256_set1_pd(dx);
+  const __m256d vdy = _mm256_set1_pd(dy);
+  const __m256d vdz = _mm256_set1_pd(dz);
+  const __m256d a = _mm256_set1_pd(dx * dx + dy * dy + dz * dz);
+  const __m256d v_t_min = _mm256_set1_pd(t_min);
+  const __m256d zero = _mm256_setzero_pd();
+  const __m256d v_last = _mm256_set1_pd(static_cast<double>(last));
+  const __m256d lane_offsets = _mm256_set_pd(3.0, 2.0, 1.0, 0.0);
+
+  __m256d best_t = _mm256_set1_pd(t_max);
+  __m256d best_index = _mm256_set1_pd(-1.0);
+
+  for (uint32_t i{first}; i < last; i += 4) {
+    const __m256d index = _mm256_add_pd(_mm256_set1_pd(static_cast<double>(i)), lane_offsets);
+
+    const __m256d cox = _mm256_sub_pd(ox, _mm256_loadu_pd(spheres.center_x() + i));
+    const __m256d coy = _mm256_sub_pd(oy, _mm256_loadu_pd(spheres.center_y() + i));
+    const __m256d coz = _mm256_sub_pd(oz, _mm256_loadu_pd(spheres.center_z() + i));
+
+    const __m256d half_b = _mm256_add_pd(
+        _mm256_add_pd(_mm256_mul_pd(cox, vdx), _mm256_mul_pd(coy, vdy)), _mm256_mul_pd(coz, vdz));
+    const __m256d c = _mm256_sub_pd(
+        _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(cox, cox), _mm256_mul_pd(coy, coy)),
+                      _mm256_mul_pd(coz, coz)),
+        _mm256_loadu_pd(spheres.radius_sq() + i));
+    const __m256d discriminant =
+        _mm256_sub_pd(_mm256_mul_pd(half_b, half_b), _mm256_mul_pd(a, c));
+
+    const __m256d hit = _mm256_and_pd(_mm256_cmp_pd(index, v_last, _CMP_LT_OQ),
+                                      _mm256_cmp_pd(discriminant, zero, _CMP_GE_OQ));
+    if (_mm256_movemask_pd(hit) == 0) { continue; }
+
+    const __m256d root = _mm256_sqrt_pd(_mm256_max_pd(discriminant, zero));
+    const __m256d neg_b = _mm256_sub_pd(zero, half_b);
+    const __m256d t_near = _mm256_div_pd(_mm256_sub_pd(neg_b, root), a);
+    const __m256d t_far = _mm256_div_pd(_mm256_add_pd(neg_b, root), a);
+
+    const __m256d near_ok =
+        _mm256_and_pd(hit, _mm256_and_pd(_mm256_cmp_pd(t_near, v_t_min, _CMP_GT_OQ),
+                                         _mm256_cmp_pd(t_near, best_t, _CMP_LT_OQ)));
+    const __m256d far_ok =
+        _mm256_and_pd(hit, _mm256_and_pd(_mm256_cmp_pd(t_far, v_t_min, _CMP_GT_OQ),
+                                         _mm256_cmp_pd(t_far, best_t, _CMP_LT_OQ)));
+    const __m256d ok = _mm256_or_pd(near_ok, far_ok);
+
+    best_t = _mm256_blendv_pd(best_t, _mm256_blendv_pd(t_far, t_near, near_ok), ok);
+    best_index = _mm256_blendv_pd(best_index, index, ok);
+  }
+
+  alignas(32) double lane_t[4];
+  alignas(32) double lane_index[4];
+  _mm256_store_pd(lane_t, best_t);
+  _mm256_store_pd(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 4);
+}
+#endif
+
+#if CGFS_AVX512_KERNELS
+CGFS_TARGET("avx512f")
+inline SphereHit intersect_spheres_avx512(const SphereSoA& spheres, const Origin& origin,
+                                          const Vec3d& direction, double t_min, double t_max,
+                                          uint32_t first, uint32_t last) {
+  const double dx = direction.get<"x">();
+  const double dy = direction.get<"y">();
+  const double dz = direction.get<"z">();
+
+  const __m512d ox = _mm512_set1_pd(origin.get<"x">());
+  const __m512d oy = _mm512_set1_pd(origin.get<"y">());
+  const __m512d oz = _mm512_set1_pd(origin.get<"z">());
+  const __m512d vdx = _mm512_set1_pd(dx);
+  const __m512d vdy = _mm512_set1_pd(dy);
+  const __m512d vdz = _mm512_set1_pd(dz);
+  const __m512d a = _mm512_set1_pd(dx * dx + dy * dy + dz * dz);
+  const __m512d v_t_min = _mm512_set1_pd(t_min);
+  const __m512d zero = _mm512_setzero_pd();
+  const __m512d v_last = _mm512_set1_pd(static_cast<double>(last));
+  const __m512d lane_offsets = _mm512_set_pd(7.0, 6.0, 5.0, 4.0, 3.0, 2.0, 1.0, 0.0);
+
+  __m512d best_t = _mm512_set1_pd(t_max);
+  __m512d best_index = _mm512_set1_pd(-1.0);
+
+  for (uint32_t i{first}; i < last; i += 8) {
+    const __m512d index = _mm512_add_pd(_mm512_set1_pd(static_cast<double>(i)), lane_offsets);
+
+    const __m512d cox = _mm512_sub_pd(ox, _mm512_loadu_pd(spheres.center_x() + i));
+    const __m512d coy = _mm512_sub_pd(oy, _mm512_loadu_pd(spheres.center_y() + i));
+    const __m512d coz = _mm512_sub_pd(oz, _mm512_loadu_pd(spheres.center_z() + i));
+
+    const __m512d half_b = _mm512_add_pd(
+        _mm512_add_pd(_mm512_mul_pd(cox, vdx), _mm512_mul_pd(coy, vdy)), _mm512_mul_pd(coz, vdz));
+    const __m512d c = _mm512_sub_pd(
+        _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(cox, cox), _mm512_mul_pd(coy, coy)),
+                      _mm512_mul_pd(coz, coz)),
+        _mm512_loadu_pd(spheres.radius_sq() + i));
+    const __m512d discriminant =
+        _mm512_sub_pd(_mm512_mul_pd(half_b, half_b), _mm512_mul_pd(a, c));
+
+    const __mmask8 hit = _mm512_cmp_pd_mask(index, v_last, _CMP_LT_OQ) &
+                         _mm512_cmp_pd_mask(discriminant, zero, _CMP_GE_OQ);
+    if (hit == 0) { continue; }
+
+    const __m512d root = _mm512_maskz_sqrt_pd(hit, discriminant);
+    const __m512d neg_b = _mm512_sub_pd(zero, half_b);
+    const __m512d t_near = _mm512_div_pd(_mm512_sub_pd(neg_b, root), a);
+    const __m512d t_far = _mm512_div_pd(_mm512_add_pd(neg_b, root), a);
+
+    const __mmask8 near_ok = hit & _mm512_cmp_pd_mask(t_near, v_t_min, _CMP_GT_OQ) &
+                             _mm512_cmp_pd_mask(t_near, best_t, _CMP_LT_OQ);
+    const __mmask8 far_ok = hit & _mm512_cmp_pd_mask(t_far, v_t_min, _CMP_GT_OQ) &
+                            _mm512_cmp_pd_mask(t_far, best_t, _CMP_LT_OQ);
+    const auto ok = static_cast<__mmask8>(near_ok | far_ok);
+
+    best_t = _mm512_mask_blend_pd(ok, best_t, _mm512_mask_blend_pd(near_ok, t_far, t_near));
+    best_index = _mm512_mask_blend_pd(ok, best_index, index);
+  }
+
+  alignas(64) double lane_t[8];
+  alignas(64) double lane_index[8];
+  _mm512_store_pd(lane_t, best_t);
+  _mm512_store_pd(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 8);
+}
+#endif
+
+/**
+ * Float kernels keep sphere indices in float lanes like the double kernels do, which is exact up
+ * to float_lane_index_limit; the dispatcher takes the scalar loop past that.
+ */
+constexpr uint32_t float_lane_index_limit = 1U << 24U;
+
+#if CGFS_SSE2_KERNELS
+CGFS_TARGET("sse2")
+inline SphereHitF intersect_spheres_sse2(const SphereSoAF& spheres, const OriginF& origin,
+                                         const Vec3f& direction, float t_min, float t_max,
+                                         uint32_t first, uint32_t last) {
+  const auto select = [](__m128 mask, __m128 if_true, __m128 if_false) {
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+  };
+
+  const float dx = direction.get<"x">();
+  const float dy = direction.get<"y">();
+  const float dz = direction.get<"z">();
+
+  const __m128 ox = _mm_set1_ps(origin.get<"x">());
+  const __m128 oy = _mm_set1_ps(origin.get<"y">());
+  const __m128 oz = _mm_set1_ps(origin.get<"z">());
+  const __m128 vdx = _mm_set1_ps(dx);
+  const __m128 vdy = _mm_set1_ps(dy);
+  const __m128 vdz = _mm_set1_ps(dz);
+  const __m128 a = _mm_set1_ps(dx * dx + dy * dy + dz * dz);
+  const __m128 v_t_min = _mm_set1_ps(t_min);
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 v_last = _mm_set1_ps(static_cast<float>(last));
+  const __m128 lane_offsets = _mm_set_ps(3.0F, 2.0F, 1.0F, 0.0F);
+
+  __m128 best_t = _mm_set1_ps(t_max);
+  __m128 best_index = _mm_set1_ps(-1.0F);
+
+  for (uint32_t i{first}; i < last; i += 4) {
+    const __m128 index = _mm_add_ps(_mm_set1_ps(static_cast<float>(i)), lane_offsets);
+
+    const __m128 cox = _mm_sub_ps(ox, _mm_loadu_ps(spheres.center_x() + i));
+    const __m128 coy = _mm_sub_ps(oy, _mm_loadu_ps(spheres.center_y() + i));
+    const __m128 coz = _mm_sub_ps(oz, _mm_loadu_ps(spheres.center_z() + i));
+
+    const __m128 half_b =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(cox, vdx), _mm_mul_ps(coy, vdy)), _mm_mul_ps(coz, vdz));
+    const __m128 c = _mm_sub_ps(
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(cox, cox), _mm_mul_ps(coy, coy)), _mm_mul_ps(coz, coz)),
+        _mm_loadu_ps(spheres.radius_sq() + i));
+    const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(half_b, half_b), _mm_mul_ps(a, c));
+
+    const __m128 hit = _mm_and_ps(_mm_cmplt_ps(index, v_last), _mm_cmpge_ps(discriminant, zero));
+    if (_mm_movemask_ps(hit) == 0) { continue; }
+
+    const __m128 root = _mm_sqrt_ps(_mm_max_ps(discriminant, zero));
+    const __m128 neg_b = _mm_sub_ps(zero, half_b);
+    const __m128 t_near = _mm_div_ps(_mm_sub_ps(neg_b, root), a);
+    const __m128 t_far = _mm_div_ps(_mm_add_ps(neg_b, root), a);
+
+    const __m128 near_ok = _mm_and_ps(
+        hit, _mm_and_ps(_mm_cmpgt_ps(t_near, v_t_min), _mm_cmplt_ps(t_near, best_t)));
+    const __m128 far_ok =
+        _mm_and_ps(hit, _mm_and_ps(_mm_cmpgt_ps(t_far, v_t_min), _mm_cmplt_ps(t_far, best_t)));
+    const __m128 ok = _mm_or_ps(near_ok, far_ok);
+
+    best_t = select(ok, select(near_ok, t_near, t_far), best_t);
+    best_index = select(ok, index, best_index);
+  }
+
+  alignas(16) float lane_t[4];
+  alignas(16) float lane_index[4];
+  _mm_store_ps(lane_t, best_t);
+  _mm_store_ps(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 4);
+}
+#endif
+
+#if CGFS_AVX2_KERNELS
+CGFS_TARGET("avx2")
+inline SphereHitF intersect_spheres_avx2(const SphereSoAF& spheres, const OriginF& origin,
+                                         const Vec3f& direction, float t_min, float t_max,
+                                         uint32_t first, uint32_t last) {
+  const float dx = direction.get<"x">();
+  const float dy = direction.get<"y">();
+  const float dz = direction.get<"z">();
+
+  const __m256 ox = _mm256_set1_ps(origin.get<"x">());
+  const __m256 oy = _mm256_set1_ps(origin.get<"y">());
+  const __m256 oz = _mm256_set1_ps(origin.get<"z">());
+  const __m256 vdx = _mm256_set1_ps(dx);
+  const __m256 vdy = _mm256_set1_ps(dy);
+  const __m256 vdz = _mm256_set1_ps(dz);
+  const __m256 a = _mm256_set1_ps(dx * dx + dy * dy + dz * dz);
+  const __m256 v_t_min = _mm256_set1_ps(t_min);
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 v_last = _mm256_set1_ps(static_cast<float>(last));
+  const __m256 lane_offsets = _mm256_set_ps(7.0F, 6.0F, 5.0F, 4.0F, 3.0F, 2.0F, 1.0F, 0.0F);
+
+  __m256 best_t = _mm256_set1_ps(t_max);
+  __m256 best_index = _mm256_set1_ps(-1.0F);
+
+  for (uint32_t i{first}; i < last; i += 8) {
+    const __m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(i)), lane_offsets);
+
+    const __m256 cox = _mm256_sub_ps(ox, _mm256_loadu_ps(spheres.center_x() + i));
+    const __m256 coy = _mm256_sub_ps(oy, _mm256_loadu_ps(spheres.center_y() + i));
+    const __m256 coz = _mm256_sub_ps(oz, _mm256_loadu_ps(spheres.center_z() + i));
+
+    const __m256 half_b = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(cox, vdx), _mm256_mul_ps(coy, vdy)), _mm256_mul_ps(coz, vdz));
+    const __m256 c = _mm256_sub_ps(
+        _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cox, cox), _mm256_mul_ps(coy, coy)),
+                      _mm256_mul_ps(coz, coz)),
+        _mm256_loadu_ps(spheres.radius_sq() + i));
+    const __m256 discriminant =
+        _mm256_sub_ps(_mm256_mul_ps(half_b, half_b), _mm256_mul_ps(a, c));
+
+    const __m256 hit = _mm256_and_ps(_mm256_cmp_ps(index, v_last, _CMP_LT_OQ),
+                                     _mm256_cmp_ps(discriminant, zero, _CMP_GE_OQ));
+    if (_mm256_movemask_ps(hit) == 0) { continue; }
+
+    const __m256 root = _mm256_sqrt_ps(_mm256_max_ps(discriminant, zero));
+    const __m256 neg_b = _mm256_sub_ps(zero, half_b);
+    const __m256 t_near = _mm256_div_ps(_mm256_sub_ps(neg_b, root), a);
+    const __m256 t_far = _mm256_div_ps(_mm256_add_ps(neg_b, root), a);
+
+    const __m256 near_ok =
+        _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(t_near, v_t_min, _CMP_GT_OQ),
+                                         _mm256_cmp_ps(t_near, best_t, _CMP_LT_OQ)));
+    const __m256 far_ok =
+        _mm256_and_ps(hit, _mm256_and_ps(_mm256_cmp_ps(t_far, v_t_min, _CMP_GT_OQ),
+                                         _mm256_cmp_ps(t_far, best_t, _CMP_LT_OQ)));
+    const __m256 ok = _mm256_or_ps(near_ok, far_ok);
+
+    best_t = _mm256_blendv_ps(best_t, _mm256_blendv_ps(t_far, t_near, near_ok), ok);
+    best_index = _mm256_blendv_ps(best_index, index, ok);
+  }
+
+  alignas(32) float lane_t[8];
+  alignas(32) float lane_index[8];
+  _mm256_store_ps(lane_t, best_t);
+  _mm256_store_ps(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 8);
+}
+#endif
+
+#if CGFS_AVX512_KERNELS
+CGFS_TARGET("avx512f")
+inline SphereHitF intersect_spheres_avx512(const SphereSoAF& spheres, const OriginF& origin,
+                                           const Vec3f& direction, float t_min, float t_max,
+                                           uint32_t first, uint32_t last) {
+  const float dx = direction.get<"x">();
+  const float dy = direction.get<"y">();
+  const float dz = direction.get<"z">();
+
+  const __m512 ox = _mm512_set1_ps(origin.get<"x">());
+  const __m512 oy = _mm512_set1_ps(origin.get<"y">());
+  const __m512 oz = _mm512_set1_ps(origin.get<"z">());
+  const __m512 vdx = _mm512_set1_ps(dx);
+  const __m512 vdy = _mm512_set1_ps(dy);
+  const __m512 vdz = _mm512_set1_ps(dz);
+  const __m512 a = _mm512_set1_ps(dx * dx + dy * dy + dz * dz);
+  const __m512 v_t_min = _mm512_set1_ps(t_min);
+  const __m512 zero = _mm512_setzero_ps();
+  const __m512 v_last = _mm512_set1_ps(static_cast<float>(last));
+  const __m512 lane_offsets =
+      _mm512_set_ps(15.0F, 14.0F, 13.0F, 12.0F, 11.0F, 10.0F, 9.0F, 8.0F, 7.0F, 6.0F, 5.0F, 4.0F,
+                    3.0F, 2.0F, 1.0F, 0.0F);
+
+  __m512 best_t = _mm512_set1_ps(t_max);
+  __m512 best_index = _mm512_set1_ps(-1.0F);
+
+  for (uint32_t i{first}; i < last; i += 16) {
+    const __m512 index = _mm512_add_ps(_mm512_set1_ps(static_cast<float>(i)), lane_offsets);
+
+    const __m512 cox = _mm512_sub_ps(ox, _mm512_loadu_ps(spheres.center_x() + i));
+    const __m512 coy = _mm512_sub_ps(oy, _mm512_loadu_ps(spheres.center_y() + i));
+    const __m512 coz = _mm512_sub_ps(oz, _mm512_loadu_ps(spheres.center_z() + i));
+
+    const __m512 half_b = _mm512_add_ps(
+        _mm512_add_ps(_mm512_mul_ps(cox, vdx), _mm512_mul_ps(coy, vdy)), _mm512_mul_ps(coz, vdz));
+    const __m512 c = _mm512_sub_ps(
+        _mm512_add_ps(_mm512_add_ps(_mm512_mul_ps(cox, cox), _mm512_mul_ps(coy, coy)),
+                      _mm512_mul_ps(coz, coz)),
+        _mm512_loadu_ps(spheres.radius_sq() + i));
+    const __m512 discriminant =
+        _mm512_sub_ps(_mm512_mul_ps(half_b, half_b), _mm512_mul_ps(a, c));
+
+    const __mmask16 hit = _mm512_cmp_ps_mask(index, v_last, _CMP_LT_OQ) &
+                          _mm512_cmp_ps_mask(discriminant, zero, _CMP_GE_OQ);
+    if (hit == 0) { continue; }
+
+    const __m512 root = _mm512_maskz_sqrt_ps(hit, discriminant);
+    const __m512 neg_b = _mm512_sub_ps(zero, half_b);
+    const __m512 t_near = _mm512_div_ps(_mm512_sub_ps(neg_b, root), a);
+    const __m512 t_far = _mm512_div_ps(_mm512_add_ps(neg_b, root), a);
+
+    const __mmask16 near_ok = hit & _mm512_cmp_ps_mask(t_near, v_t_min, _CMP_GT_OQ) &
+                              _mm512_cmp_ps_mask(t_near, best_t, _CMP_LT_OQ);
+    const __mmask16 far_ok = hit & _mm512_cmp_ps_mask(t_far, v_t_min, _CMP_GT_OQ) &
+                             _mm512_cmp_ps_mask(t_far, best_t, _CMP_LT_OQ);
+    const auto ok = static_cast<__mmask16>(near_ok | far_ok);
+
+    best_t = _mm512_mask_blend_ps(ok, best_t, _mm512_mask_blend_ps(near_ok, t_far, t_near));
+    best_index = _mm512_mask_blend_ps(ok, best_index, index);
+  }
+
+  alignas(64) float lane_t[16];
+  alignas(64) float lane_index[16];
+  _mm512_store_ps(lane_t, best_t);
+  _mm512_store_ps(lane_index, best_index);
+  return reduce_lanes(lane_t, lane_index, 16);
+}
+#endif
+
+}  // namespace detail
+
+/**
+ * @brief First sphere in [first, last) found to block the ray within (t_min, t_max)
+ *
+ * Stops at the first blocker, which need not be the nearest. Leaves hold only a handful of
+ * spheres and most shadow rays exit on an early one, so this stays a scalar loop rather than a
+ * vector kernel.
+ *
+ * @return index of the blocking sphere, or no_sphere
+ */
+template <typename Scalar>
+uint32_t first_sphere_hit(const BasicSphereSoA<Scalar>& spheres, const Vec3<Scalar>& origin,
+                          const Vec3<Scalar>& direction, std::type_identity_t<Scalar> t_min,
+                          std::type_identity_t<Scalar> t_max, uint32_t first, uint32_t last) {
+  const Scalar ox = origin.template get<"x">();
+  const Scalar oy = origin.template get<"y">();
+  const Scalar oz = origin.template get<"z">();
+  const Scalar dx = direction.template get<"x">();
+  const Scalar dy = direction.template get<"y">();
+  const Scalar dz = direction.template get<"z">();
+  const Scalar a = dx * dx + dy * dy + dz * dz;
+
+  for (uint32_t i{first}; i < last; ++i) {
+    const Scalar cox = ox - spheres.center_x()[i];
+    const Scalar coy = oy - spheres.center_y()[i];
+    const Scalar coz = oz - spheres.center_z()[i];
+
+    const Scalar half_b = cox * dx + coy * dy + coz * dz;
+    const Scalar c = cox * cox + coy * coy + coz * coz - spheres.radius_sq()[i];
+    if (quadratic_has_root_between(a, half_b, c, t_min, t_max)) { return i; }
+  }
+
+  return no_sphere;
+}
+
+/**
+ * @brief Whether any sphere in [first, last) blocks the ray within (t_min, t_max)
+ */
+template <typename Scalar>
+bool any_sphere_hit(const BasicSphereSoA<Scalar>& spheres, const Vec3<Scalar>& origin,
+                    const Vec3<Scalar>& direction, std::type_identity_t<Scalar> t_min,
+                    std::type_identity_t<Scalar> t_max, uint32_t first, uint32_t last) {
+  return first_sphere_hit(spheres, origin, direction, t_min, t_max, first, last) != no_sphere;
+}
+
+namespace detail {
+
+template <typename Scalar>
+using IntersectSpheresKernel = BasicSphereHit<Scalar> (*)(const BasicSphereSoA<Scalar>&,
+                                                          const Vec3<Scalar>&,
+                                                          const Vec3<Scalar>&, Scalar, Scalar,
+                                                          uint32_t, uint32_t);
+
+/**
+ * @brief The kernel for a SIMD level; levels this build has no kernel for get the scalar loop
+ */
+template <typename Scalar>
+IntersectSpheresKernel<Scalar> intersect_spheres_kernel(SimdLevel level) {
+  switch (level) {
+#if CGFS_AVX512_KERNELS
+    case SimdLevel::avx512:
+      return intersect_spheres_avx512;
+#endif
+#if CGFS_AVX2_KERNELS
+    case SimdLevel::avx2:
+      return intersect_spheres_avx2;
+#endif
+#if CGFS_SSE2_KERNELS
+    case SimdLevel::sse2:
+      return intersect_spheres_sse2;
+#endif
+    default:
+      return intersect_spheres_scalar<Scalar>;
+  }
+}
+
+template <typename Scalar>
+BasicSphereHit<Scalar> bind_intersect_spheres(const BasicSphereSoA<Scalar>& spheres,
+                                              const Vec3<Scalar>& origin,
+                                              const Vec3<Scalar>& direction, Scalar t_min,
+                                              Scalar t_max, uint32_t first, uint32_t last);
+
+/**
+ * @brief Kernel intersect_spheres runs, bound on its first call and on every SIMD level change
+ */
+template <typename Scalar>
+inline constinit std::atomic<IntersectSpheresKernel<Scalar>> bound_intersect_spheres{
+    &bind_intersect_spheres<Scalar>};
+
+template <typename Scalar>
+void rebind_intersect_spheres() {
+  bound_intersect_spheres<Scalar>.store(intersect_spheres_kernel<Scalar>(simd_level()),
+                                        std::memory_order_relaxed);
+}
+
+template <typename Scalar>
+BasicSphereHit<Scalar> bind_intersect_spheres(const BasicSphereSoA<Scalar>& spheres,
+                                              const Vec3<Scalar>& origin,
+                                              const Vec3<Scalar>& direction, Scalar t_min,
+                                              Scalar t_max, uint32_t first, uint32_t last) {
+  bind_simd_kernel(&rebind_intersect_spheres<Scalar>);
+  return bound_intersect_spheres<Scalar>.load(std::memory_order_relaxed)(
+      spheres, origin, direction, t_min, t_max, first, last);
+}
+
+/**
+ * @brief Hand the query to the kernel for the active SIMD level, see simd_level
+ */
+template <typename Scalar>
+BasicSphereHit<Scalar> dispatch_intersect_spheres(const BasicSphereSoA<Scalar>& spheres,
+                                                  const Vec3<Scalar>& origin,
+                                                  const Vec3<Scalar>& direction, Scalar t_min,
+                                                  Scalar t_max, uint32_t first, uint32_t last) {
+  return bound_intersect_spheres<Scalar>.load(std::memory_order_relaxed)(
+      spheres, origin, direction, t_min, t_max, first, last);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Find the nearest sphere in [first, last) hit within (t_min, t_max)
+ *
+ * Runs the kernel for the active SIMD level through a pointer bound on first use: 8 lanes with
+ * AVX-512F, 4 with AVX2 and 2 with SSE2. Every kernel finds the same hit.
+ *
+ * @return nearest t and sphere index, or {basically_infinity, no_sphere} on a miss
+ */
+inline SphereHit intersect_spheres(const SphereSoA& spheres, const Origin& origin,
+                                   const Vec3d& direction, double t_min, double t_max,
+                                   uint32_t first, uint32_t last) {
+  return detail::dispatch_intersect_spheres(spheres, origin, direction, t_min, t_max, first,
+                                            last);
+}
+
+/**
+ * @brief Single precision nearest hit, with twice the lanes per kernel: 16 with AVX-512F, 8 with
+ * AVX2 and 4 with SSE2
+ */
+inline SphereHitF intersect_spheres(const SphereSoAF& spheres, const OriginF& origin,
+                                    const Vec3f& direction, float t_min, float t_max,
+                                    uint32_t first, uint32_t last) {
+  if (last > detail::float_lane_index_limit) {
+    return detail::intersect_spheres_scalar(spheres, origin, direction, t_min, t_max, first, last);
+  }
+  return detail::dispatch_intersect_spheres(spheres, origin, direction, t_min, t_max, first,
+                                            last);
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_SPHERE_SOA_HPP
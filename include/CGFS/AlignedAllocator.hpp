@@ -0,0 +1,56 @@
+/**
+ * @brief Allocator for over-aligned contiguous storage
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_ALIGNED_ALLOCATOR_HPP
+#define CGFS_ALIGNED_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Cache line size used to align SIMD streams
+ */
+constexpr std::size_t cache_line_size = 64;
+
+template <typename Type, std::size_t Alignment = cache_line_size>
+struct AlignedAllocator {
+  static_assert(Alignment >= alignof(Type), "Alignment must not weaken the natural alignment.");
+
+  using value_type = Type;
+
+  template <typename Other>
+  struct rebind {
+    using other = AlignedAllocator<Other, Alignment>;
+  };
+
+  constexpr AlignedAllocator() noexcept = default;
+
+  template <typename Other>
+  constexpr AlignedAllocator(const AlignedAllocator<Other, Alignment>&) noexcept {}
+
+  [[nodiscard]] Type* allocate(std::size_t count) {
+    return static_cast<Type*>(::operator new(count * sizeof(Type), std::align_val_t{Alignment}));
+  }
+
+  void deallocate(Type* ptr, std::size_t count) noexcept {
+    ::operator delete(ptr, count * sizeof(Type), std::align_val_t{Alignment});
+  }
+
+  template <typename Other>
+  constexpr bool operator==(const AlignedAllocator<Other, Alignment>&) const noexcept {
+    return true;
+  }
+};
+
+template <typename Type>
+using AlignedVector = std::vector<Type, AlignedAllocator<Type>>;
+
+}  // namespace cgfs
+
+#endif  // CGFS_ALIGNED_ALLOCATOR_HPP
@@ -9,19 +9,56 @@
 
 #include <CGFS/Common.hpp>
 
+#include <array>
+
 namespace cgfs {
 
 using Origin = Vec3d;
-using ProjectionPlane = mguid::NamedTuple<mguid::NamedType<"distance", double>>;
+using OriginF = Vec3f;
+
+template <typename Scalar>
+using BasicProjectionPlane = mguid::NamedTuple<mguid::NamedType<"distance", Scalar>>;
+
+using ProjectionPlane = BasicProjectionPlane<double>;
+
+/**
+ * @brief Camera fields in a given scalar type; rays generated from it carry the same type
+ */
+template <typename Scalar>
+using BasicCameraProperties =
+    mguid::NamedTuple<mguid::NamedType<"origin", Vec3<Scalar>>,
+                      mguid::NamedType<"rotation", std::array<std::array<Scalar, 3>, 3>>,
+                      mguid::NamedType<"projection_plane", BasicProjectionPlane<Scalar>>>;
 
-using CameraProperties = mguid::NamedTuple<mguid::NamedType<"origin", Origin>,
-                                           mguid::NamedType<"rotation", Mat3d>,
-                                           mguid::NamedType<"projection_plane", ProjectionPlane>>;
+using CameraProperties = BasicCameraProperties<double>;
 
-struct Camera : CameraProperties {
-  using CameraProperties::CameraProperties;
-  using CameraProperties::get;
+template <typename Scalar>
+struct BasicCamera : BasicCameraProperties<Scalar> {
+  using Properties = BasicCameraProperties<Scalar>;
+  using Properties::Properties;
+  using Properties::get;
 };
 
+using Camera = BasicCamera<double>;
+using CameraF = BasicCamera<float>;
+
+/**
+ * @brief The same camera with every field converted to another scalar type
+ */
+template <typename To, typename From>
+constexpr BasicCamera<To> camera_cast(const BasicCamera<From>& camera) {
+  const auto& rotation = camera.template get<"rotation">();
+
+  std::array<std::array<To, 3>, 3> converted_rotation;
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) { converted_rotation[i][j] = static_cast<To>(rotation[i][j]); }
+  }
+
+  return BasicCamera<To>{
+      vec3_cast<To>(camera.template get<"origin">()), converted_rotation,
+      BasicProjectionPlane<To>{
+          static_cast<To>(camera.template get<"projection_plane">().template get<"distance">())}};
+}
+
 }  // namespace cgfs
 #endif  // CGFS_CAMERA_HPP
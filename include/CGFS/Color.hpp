@@ -184,6 +184,15 @@ struct Color3 : RGB8Bit {
   }
 };
 
+/**
+ * @brief Convert an unclamped linear color in [0, 255] units to 8 bit, saturating each channel
+ */
+constexpr Color3 to_color3(const RGB64F& color) {
+  return Color3{static_cast<uint8_t>(std::clamp(color.get<"r">(), 0.0, 255.0)),
+                static_cast<uint8_t>(std::clamp(color.get<"g">(), 0.0, 255.0)),
+                static_cast<uint8_t>(std::clamp(color.get<"b">(), 0.0, 255.0))};
+}
+
 }  // namespace cgfs
 
 #endif  // CGFS_COLOR_HPP
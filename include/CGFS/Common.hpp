@@ -87,6 +87,24 @@ using Mat4u64 = std::array<std::array<uint64_t, 4>, 4>;
 
 constexpr double basically_infinity = 1'000'000'000'000;
 
+template <typename To, typename From>
+constexpr Vec3<To> vec3_cast(const Vec3<From>& vec) {
+  return Vec3<To>{static_cast<To>(vec.template get<"x">()),
+                  static_cast<To>(vec.template get<"y">()),
+                  static_cast<To>(vec.template get<"z">())};
+}
+
+/**
+ * @brief Scalar type a scene's rays are traced in, double unless the scene type says otherwise
+ */
+template <typename SceneType>
+struct SceneScalar {
+  using type = double;
+};
+
+template <typename SceneType>
+using scene_scalar_t = typename SceneScalar<SceneType>::type;
+
 }  // namespace cgfs
 
 constexpr inline cgfs::Vec3d operator-(const cgfs::Vec3d& lhs, const cgfs::Vec3d& rhs) {
@@ -128,4 +146,43 @@ constexpr inline cgfs::Vec3d operator*(const cgfs::Mat3d& mat, const cgfs::Vec3d
   return cgfs::Vec3d(result[0], result[1], result[2]);
 }
 
+constexpr inline cgfs::Vec3f operator-(const cgfs::Vec3f& lhs, const cgfs::Vec3f& rhs) {
+  return cgfs::Vec3f{lhs.get<"x">() - rhs.get<"x">(), lhs.get<"y">() - rhs.get<"y">(),
+                     lhs.get<"z">() - rhs.get<"z">()};
+}
+
+constexpr inline cgfs::Vec3f operator-(const cgfs::Vec3f& val) {
+  return cgfs::Vec3f{-val.get<"x">(), -val.get<"y">(), -val.get<"z">()};
+}
+
+constexpr inline cgfs::Vec3f operator+(const cgfs::Vec3f& lhs, const cgfs::Vec3f& rhs) {
+  return cgfs::Vec3f{lhs.get<"x">() + rhs.get<"x">(), lhs.get<"y">() + rhs.get<"y">(),
+                     lhs.get<"z">() + rhs.get<"z">()};
+}
+
+constexpr inline cgfs::Vec3f operator*(float val, const cgfs::Vec3f& rhs) {
+  return cgfs::Vec3f{rhs.get<"x">() * val, rhs.get<"y">() * val, rhs.get<"z">() * val};
+}
+
+constexpr inline cgfs::Vec3f operator*(const cgfs::Vec3f& rhs, float val) {
+  return cgfs::Vec3f{rhs.get<"x">() * val, rhs.get<"y">() * val, rhs.get<"z">() * val};
+}
+
+constexpr inline cgfs::Vec3f operator/(const cgfs::Vec3f& lhs, float val) {
+  return cgfs::Vec3f{lhs.get<"x">() / val, lhs.get<"y">() / val, lhs.get<"z">() / val};
+}
+
+constexpr inline cgfs::Vec3f operator*(const cgfs::Mat3f& mat, const cgfs::Vec3f& vec3) {
+  std::array result{0.0F, 0.0F, 0.0F};
+  std::array<float, 3> vec{vec3.get<0>(), vec3.get<1>(), vec3.get<2>()};
+
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) {
+      result[i] += vec[j]*mat[i][j];
+    }
+  }
+
+  return cgfs::Vec3f(result[0], result[1], result[2]);
+}
+
 #endif  // CPPTEMPLATE_COMMON_HPP
@@ -0,0 +1,268 @@
+/**
+ * @brief Render-time scene representation with acceleration structures
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_COMPILED_SCENE_HPP
+#define CGFS_COMPILED_SCENE_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Lighting/PreparedLights.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Shapes.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/ShapeIntersection.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace cgfs {
+
+using CompiledSceneProperties =
+    mguid::NamedTuple<mguid::NamedType<"materials", std::vector<MaterialProperties>>,
+                      mguid::NamedType<"sphere_materials", std::vector<uint32_t>>,
+                      mguid::NamedType<"lights", std::vector<Light>>,
+                      mguid::NamedType<"prepared_lights", PreparedLights>,
+                      mguid::NamedType<"background_color", Color3>,
+                      mguid::NamedType<"bvh", BVH>,
+                      mguid::NamedType<"spheres", SphereSoA>,
+                      mguid::NamedType<"shapes", ShapeArrays>>;
+
+/**
+ * @brief A scene prepared for tracing
+ *
+ * Spheres are stored in BVH leaf order, so a leaf addresses a contiguous run of them, and split
+ * hot from cold: their geometry goes into a SphereSoA, which is all the intersection kernels
+ * read, while their materials are deduplicated into a material table that sphere_materials
+ * indexes per leaf slot. Materials are only looked up once the closest hit is known.
+ *
+ * The lights are kept as given and also prepared for shading, see PreparedLights.
+ *
+ * Other primitives stay in their per-type arrays and are tested outside the BVH.
+ */
+struct CompiledScene : CompiledSceneProperties {
+  using CompiledSceneProperties::CompiledSceneProperties;
+  using CompiledSceneProperties::get;
+};
+
+namespace detail {
+
+/**
+ * @brief Hash of every field of a material, for deduplicating material tables
+ */
+struct MaterialHash {
+  size_t operator()(const MaterialProperties& material) const {
+    const auto& color = material.get<"color">();
+    size_t seed = (size_t{color.get<"r">()} << 16U) | (size_t{color.get<"g">()} << 8U) |
+                  size_t{color.get<"b">()};
+    for (const double value : {material.get<"specular">(), material.get<"reflective">()}) {
+      seed ^= std::hash<double>{}(value) + 0x9e3779b97f4a7c15ULL + (seed << 6U) + (seed >> 2U);
+    }
+    return seed;
+  }
+};
+
+inline AABB sphere_bounds(const SphereSoA& spheres, size_t slot) {
+  const Vec3d center{spheres.center_x()[slot], spheres.center_y()[slot],
+                     spheres.center_z()[slot]};
+  const double r = spheres.radius()[slot];
+  return AABB{center - Vec3d{r, r, r}, center + Vec3d{r, r, r}};
+}
+
+}  // namespace detail
+
+/**
+ * @brief Build a compiled scene from any contiguous run of objects and lights
+ */
+inline CompiledScene compile_scene(std::span<const Sphere> objects, std::span<const Light> lights,
+                                   const Color3& background_color,
+                                   ShapeArrays shapes = ShapeArrays{}) {
+  std::vector<AABB> bounds;
+  bounds.reserve(objects.size());
+  for (const auto& sphere : objects) { bounds.push_back(bounds_of(sphere)); }
+
+  BVH bvh{bounds};
+
+  std::vector<Sphere> ordered;
+  ordered.reserve(objects.size());
+  for (const auto index : bvh.primitive_order()) { ordered.push_back(objects[index]); }
+
+  std::vector<MaterialProperties> materials;
+  std::vector<uint32_t> sphere_materials;
+  sphere_materials.reserve(ordered.size());
+  std::unordered_map<MaterialProperties, uint32_t, detail::MaterialHash> material_ids;
+  for (const auto& sphere : ordered) {
+    const auto [entry, inserted] = material_ids.try_emplace(
+        sphere.get<"material">(), static_cast<uint32_t>(materials.size()));
+    if (inserted) { materials.push_back(sphere.get<"material">()); }
+    sphere_materials.push_back(entry->second);
+  }
+
+  SphereSoA spheres{ordered};
+
+  return CompiledScene{std::move(materials), std::move(sphere_materials),
+                       std::vector<Light>(lights.begin(), lights.end()), prepare_lights(lights),
+                       background_color, std::move(bvh), std::move(spheres), std::move(shapes)};
+}
+
+template <size_t NumObjects, size_t NumLights>
+CompiledScene compile_scene(const Scene<NumObjects, NumLights>& scene) {
+  return compile_scene(scene.template get<"objects">(), scene.template get<"lights">(),
+                       scene.template get<"background_color">());
+}
+
+inline CompiledScene compile_scene(const DynamicScene& scene) {
+  return compile_scene(scene.get<"objects">(), scene.get<"lights">(),
+                       scene.get<"background_color">(), scene.get<"shapes">());
+}
+
+/**
+ * @brief Compile a scene that is no longer needed, moving its shapes instead of copying them
+ */
+inline CompiledScene compile_scene(DynamicScene&& scene) {
+  return compile_scene(scene.get<"objects">(), scene.get<"lights">(),
+                       scene.get<"background_color">(), std::move(scene.get<"shapes">()));
+}
+
+/**
+ * @brief Replace one sphere of a compiled scene, refitting the BVH around it
+ * @param scene scene to edit
+ * @param index index of the sphere in the Scene the compiled scene was built from
+ * @param sphere new sphere
+ * @return the sphere that was replaced
+ */
+inline Sphere update_sphere(CompiledScene& scene, size_t index, const Sphere& sphere) {
+  auto& spheres = scene.get<"spheres">();
+  auto& materials = scene.get<"materials">();
+  auto& sphere_materials = scene.get<"sphere_materials">();
+  auto& bvh = scene.get<"bvh">();
+
+  const auto& order = bvh.primitive_order();
+  const auto position = static_cast<size_t>(
+      std::distance(order.begin(), std::find(order.begin(), order.end(), index)));
+  if (position == order.size()) { throw std::out_of_range("No sphere with that index."); }
+
+  const Sphere previous{
+      Vec3d{spheres.center_x()[position], spheres.center_y()[position],
+            spheres.center_z()[position]},
+      spheres.radius()[position], materials[sphere_materials[position]]};
+
+  // Edits are rare, so a linear search of the table is cheaper than keeping its index around
+  const auto material = std::find(materials.begin(), materials.end(), sphere.get<"material">());
+  sphere_materials[position] = static_cast<uint32_t>(std::distance(materials.begin(), material));
+  if (material == materials.end()) { materials.push_back(sphere.get<"material">()); }
+  spheres.set(position, sphere);
+
+  std::vector<AABB> bounds(spheres.size());
+  for (size_t i{0}; i < spheres.size(); ++i) {
+    bounds[order[i]] = detail::sphere_bounds(spheres, i);
+  }
+  bvh.refit(bounds);
+
+  return previous;
+}
+
+/**
+ * @brief Give the scene's point lights a range, beyond which shading skips them
+ *
+ * Lights in this renderer do not fall off with distance, so a radius is a hard cutoff and
+ * changes the image wherever a light reached further; pick radii where its contribution no
+ * longer matters. The lights are prepared again, everything else is left as it is.
+ *
+ * @param scene scene to edit
+ * @param influence_radii one radius per light, in the scene's light order; basically_infinity
+ * leaves a light unbounded
+ * @throws std::invalid_argument if there is not one radius per light
+ */
+inline void limit_light_influence(CompiledScene& scene,
+                                  std::span<const double> influence_radii) {
+  if (influence_radii.size() != scene.get<"lights">().size()) {
+    throw std::invalid_argument("Need one influence radius per light.");
+  }
+  scene.get<"prepared_lights">() = prepare_lights(scene.get<"lights">(), influence_radii);
+}
+
+/**
+ * @brief Resolve a sphere hit of a compiled scene to its material, normal and identity
+ *
+ * The normal is left unnormalized, so hit_normal normalizes it with the shading precision
+ * policy like it does for Sphere objects.
+ *
+ * @param slot leaf order index of the sphere that was hit
+ */
+inline ClosestIntersectionResult sphere_hit(const CompiledScene& scene, uint32_t slot,
+                                            const Origin& origin, const Vec3d& direction,
+                                            double t) {
+  const auto& spheres = scene.get<"spheres">();
+  const Vec3d center{spheres.center_x()[slot], spheres.center_y()[slot],
+                     spheres.center_z()[slot]};
+  return ClosestIntersectionResult{
+      nullptr, t,
+      ShapeHit{&scene.get<"materials">()[scene.get<"sphere_materials">()[slot]],
+               origin + (t * direction) - center, spheres.center_x() + slot, false}};
+}
+
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const CompiledScene& scene) {
+  const auto& spheres = scene.get<"spheres">();
+
+  // Shapes first, so a hit on them already bounds the BVH walk
+  const auto shape_hit =
+      closest_intersection(origin, direction, t_min, t_max, scene.get<"shapes">());
+  if (is_hit(shape_hit)) { t_max = shape_hit.get<"closest_t">(); }
+
+  double closest_t_value = basically_infinity;
+  uint32_t closest_slot = no_sphere;
+
+  const auto visit_leaf = [&](uint32_t first, uint32_t count) {
+    const auto hit =
+        intersect_spheres(spheres, origin, direction, t_min, t_max, first, first + count);
+    if (hit.get<"index">() != no_sphere) {
+      closest_t_value = hit.get<"t">();
+      closest_slot = hit.get<"index">();
+      // Boxes starting past the current hit cannot hold a closer one
+      t_max = closest_t_value;
+    }
+    return false;
+  };
+  scene.get<"bvh">().traverse(origin, direction, t_min, t_max, visit_leaf);
+
+  if (closest_slot == no_sphere) { return shape_hit; }
+  return sphere_hit(scene, closest_slot, origin, direction, closest_t_value);
+}
+
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const CompiledScene& scene) {
+  const auto& spheres = scene.get<"spheres">();
+
+  if (occluded(origin, direction, t_min, t_max, scene.get<"shapes">())) { return true; }
+
+  return scene.get<"bvh">().traverse(
+      origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+        return any_sphere_hit(spheres, origin, direction, t_min, t_max, first, first + count);
+      });
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_COMPILED_SCENE_HPP
@@ -0,0 +1,228 @@
+/**
+ * @brief Single precision copy of a compiled scene
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_COMPILED_SCENE_F_HPP
+#define CGFS_COMPILED_SCENE_F_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/Lighting/PreparedLights.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Shapes.hpp"
+#include "CGFS/Precision.hpp"
+#include "CGFS/Tracing/ShapeIntersection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Prepared lights in single precision, see PreparedLights
+ */
+using PreparedLightsF = BasicPreparedLights<float>;
+
+using CompiledScenePropertiesF =
+    mguid::NamedTuple<mguid::NamedType<"materials", std::vector<MaterialProperties>>,
+                      mguid::NamedType<"sphere_materials", std::vector<uint32_t>>,
+                      mguid::NamedType<"prepared_lights", PreparedLightsF>,
+                      mguid::NamedType<"background_color", Color3>,
+                      mguid::NamedType<"bvh", BVH>,
+                      mguid::NamedType<"spheres", SphereSoAF>,
+                      mguid::NamedType<"shapes", ShapeArrays>>;
+
+/**
+ * @brief A compiled scene traced in float instead of double
+ *
+ * Sphere geometry and lights are narrowed to float, so the intersection kernels run twice the
+ * lanes per instruction and read half the bytes per sphere. The BVH and material table are
+ * shared in layout with the double scene; boxes are still tested in double, on the float ray
+ * widened once per traversal.
+ *
+ * Other shapes are few and cheap next to the spheres, so they stay in double: their queries run
+ * on the widened ray and the hit is narrowed back. Scenes far from the origin or with spheres
+ * much smaller than their distance to the camera want the double path.
+ */
+struct CompiledSceneF : CompiledScenePropertiesF {
+  using CompiledScenePropertiesF::CompiledScenePropertiesF;
+  using CompiledScenePropertiesF::get;
+};
+
+template <>
+struct SceneScalar<CompiledSceneF> {
+  using type = float;
+};
+
+/**
+ * @brief Narrow a compiled scene to single precision
+ */
+inline CompiledSceneF to_single_precision(const CompiledScene& scene) {
+  const auto& spheres = scene.get<"spheres">();
+  const auto& materials = scene.get<"materials">();
+  const auto& sphere_materials = scene.get<"sphere_materials">();
+  std::vector<Sphere> ordered;
+  ordered.reserve(spheres.size());
+  for (size_t slot{0}; slot < spheres.size(); ++slot) {
+    ordered.emplace_back(
+        Vec3d{spheres.center_x()[slot], spheres.center_y()[slot], spheres.center_z()[slot]},
+        spheres.radius()[slot], materials[sphere_materials[slot]]);
+  }
+
+  return CompiledSceneF{materials,
+                        sphere_materials,
+                        prepared_lights_cast<float>(scene.get<"prepared_lights">()),
+                        scene.get<"background_color">(),
+                        scene.get<"bvh">(),
+                        SphereSoAF{ordered},
+                        scene.get<"shapes">()};
+}
+
+/**
+ * @brief Closest hit of a single precision scene; material is null for a miss
+ *
+ * normal and unit_normal mean what they do in ShapeHit: sphere hits leave the normal for
+ * hit_normal to normalize, shape hits carry the unit normal of the double query. surface_error
+ * bounds how far the hit point may be off the surface, see spawn_point.
+ */
+using ClosestIntersectionResultF =
+    mguid::NamedTuple<mguid::NamedType<"closest_t", float>,
+                      mguid::NamedType<"material", MaterialProperties const*>,
+                      mguid::NamedType<"normal", Vec3f>,
+                      mguid::NamedType<"unit_normal", bool>,
+                      mguid::NamedType<"object", const void*>,
+                      mguid::NamedType<"surface_error", float>>;
+
+constexpr bool is_hit(const ClosestIntersectionResultF& hit) {
+  return hit.get<"material">() != nullptr;
+}
+
+constexpr const MaterialProperties& hit_material(const ClosestIntersectionResultF& hit) {
+  return *hit.get<"material">();
+}
+
+template <typename Precision = ExactMath>
+constexpr Vec3f hit_normal(const ClosestIntersectionResultF& hit, const Vec3f&) {
+  return hit.get<"unit_normal">() ? hit.get<"normal">() : Precision::normalize(hit.get<"normal">());
+}
+
+constexpr const void* hit_object(const ClosestIntersectionResultF& hit) {
+  return hit.get<"object">();
+}
+
+/**
+ * @brief Origin for the shadow and reflection rays leaving a float hit
+ *
+ * In float, |o - c|^2 - r^2 loses the low bits of the sphere's squared extent, so a ray leaving
+ * a big sphere can find it again a little way out, and one from a point left just inside finds
+ * itself in shadow. Lifting the point along the normal by the error bound keeps those rays off
+ * their own surface, at a shift too small to see on spheres of a sensible size.
+ */
+constexpr Vec3f spawn_point(const ClosestIntersectionResultF& hit, const Vec3f& point,
+                            const Vec3f& normal) {
+  return point + (hit.get<"surface_error">() * normal);
+}
+
+namespace detail {
+
+inline float max_abs(const Vec3f& vec) {
+  return std::max({std::abs(vec.get<"x">()), std::abs(vec.get<"y">()), std::abs(vec.get<"z">())});
+}
+
+}  // namespace detail
+
+inline ClosestIntersectionResultF closest_intersection(const OriginF& origin,
+                                                       const Vec3f& direction, float t_min,
+                                                       float t_max, const CompiledSceneF& scene) {
+  const auto& spheres = scene.get<"spheres">();
+
+  // Shapes first, in double, so a hit on them already bounds the BVH walk
+  const auto shape_hit = closest_intersection(vec3_cast<double>(origin),
+                                              vec3_cast<double>(direction), t_min, t_max,
+                                              scene.get<"shapes">());
+  double box_t_max = is_hit(shape_hit) ? shape_hit.get<"closest_t">() : t_max;
+
+  float closest_t_value = static_cast<float>(box_t_max);
+  uint32_t closest_slot = no_sphere;
+
+  scene.get<"bvh">().traverse(
+      vec3_cast<double>(origin), vec3_cast<double>(direction), t_min, box_t_max,
+      [&](uint32_t first, uint32_t count) {
+        const auto hit = intersect_spheres(spheres, origin, direction, t_min, closest_t_value,
+                                           first, first + count);
+        if (hit.get<"index">() != no_sphere) {
+          closest_t_value = hit.get<"t">();
+          closest_slot = hit.get<"index">();
+          box_t_max = closest_t_value;
+        }
+        return false;
+      });
+
+  if (closest_slot == no_sphere) {
+    if (!is_hit(shape_hit)) {
+      return ClosestIntersectionResultF{static_cast<float>(basically_infinity), nullptr, Vec3f{},
+                                        false, nullptr, 0.0F};
+    }
+
+    // The narrowed t and the point built from it each round by half an epsilon of their size
+    const auto& shape = shape_hit.get<"closest_shape">();
+    const Vec3f point = origin + (closest_t_value * direction);
+    const float surface_error =
+        std::numeric_limits<float>::epsilon() *
+        (detail::max_abs(point) + closest_t_value * detail::max_abs(direction));
+    return ClosestIntersectionResultF{closest_t_value,
+                                      shape.get<"material">(),
+                                      vec3_cast<float>(shape.get<"normal">()),
+                                      shape.get<"unit_normal">(),
+                                      shape.get<"object">(),
+                                      surface_error};
+  }
+
+  const Vec3f center{spheres.center_x()[closest_slot], spheres.center_y()[closest_slot],
+                     spheres.center_z()[closest_slot]};
+  const float extent = detail::max_abs(center) + spheres.radius()[closest_slot];
+  // Storing the hit rounds each coordinate by half an epsilon of |c| + r, and a ray leaving the
+  // sphere rounds |o - c|^2 - r^2 at the scale of r^2, about half an epsilon of r in height.
+  // Half an epsilon of the extent covers both. On the radius 5000 ground sphere of the tracer
+  // tests, at 720x720, no lift leaves 1.7% of pixels more than a step off double, this lift
+  // 0.07%, and a full epsilon 0.11% as the shift itself starts to show
+  const float surface_error = 0.5F * std::numeric_limits<float>::epsilon() * extent;
+
+  return ClosestIntersectionResultF{
+      closest_t_value, &scene.get<"materials">()[scene.get<"sphere_materials">()[closest_slot]],
+      origin + (closest_t_value * direction) - center, false, spheres.center_x() + closest_slot,
+      surface_error};
+}
+
+inline bool occluded(const OriginF& origin, const Vec3f& direction, float t_min, float t_max,
+                     const CompiledSceneF& scene) {
+  const auto& spheres = scene.get<"spheres">();
+
+  if (occluded(vec3_cast<double>(origin), vec3_cast<double>(direction), t_min, t_max,
+               scene.get<"shapes">())) {
+    return true;
+  }
+
+  double box_t_max = t_max;
+  return scene.get<"bvh">().traverse(
+      vec3_cast<double>(origin), vec3_cast<double>(direction), t_min, box_t_max,
+      [&](uint32_t first, uint32_t count) {
+        return any_sphere_hit(spheres, origin, direction, t_min, t_max, first, first + count);
+      });
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_COMPILED_SCENE_F_HPP
@@ -0,0 +1,224 @@
+/**
+ * @brief Runtime choice of the SIMD kernels to run on this CPU
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_CPU_FEATURES_HPP
+#define CGFS_CPU_FEATURES_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+/*
+ * With GCC or Clang on x86-64 every kernel variant is compiled into each translation unit with
+ * a target attribute, whatever -m flags the build uses, and the variant to run is picked at
+ * runtime. Other compilers and architectures only get the variants their flags enable.
+ *
+ * GCC's avx512f target brings FMA along and would fuse the kernels' multiply-adds, so variants
+ * would round differently; contraction is turned off to keep every variant bit for bit alike.
+ */
+#if defined(__x86_64__) && defined(__clang__)
+#define CGFS_RUNTIME_DISPATCH 1
+#define CGFS_TARGET(isa) __attribute__((target(isa)))
+#elif defined(__x86_64__) && defined(__GNUC__)
+#define CGFS_RUNTIME_DISPATCH 1
+#define CGFS_TARGET(isa) __attribute__((target(isa), optimize("fp-contract=off")))
+#else
+#define CGFS_RUNTIME_DISPATCH 0
+#define CGFS_TARGET(isa)
+#endif
+
+#if CGFS_RUNTIME_DISPATCH || defined(__SSE2__)
+#define CGFS_SSE2_KERNELS 1
+#else
+#define CGFS_SSE2_KERNELS 0
+#endif
+
+#if CGFS_RUNTIME_DISPATCH || defined(__AVX2__)
+#define CGFS_AVX2_KERNELS 1
+#else
+#define CGFS_AVX2_KERNELS 0
+#endif
+
+#if CGFS_RUNTIME_DISPATCH || defined(__AVX512F__)
+#define CGFS_AVX512_KERNELS 1
+#else
+#define CGFS_AVX512_KERNELS 0
+#endif
+
+namespace cgfs {
+
+/**
+ * @brief Kernel variants, each needing the one before it
+ *
+ * sse2 is also what SSE4.2 machines run, since the kernels use nothing newer.
+ */
+enum class SimdLevel : uint8_t { scalar, sse2, avx2, avx512 };
+
+constexpr std::string_view simd_level_name(SimdLevel level) {
+  switch (level) {
+    case SimdLevel::scalar:
+      return "scalar";
+    case SimdLevel::sse2:
+      return "sse2";
+    case SimdLevel::avx2:
+      return "avx2";
+    case SimdLevel::avx512:
+      return "avx512";
+  }
+  return "scalar";
+}
+
+constexpr std::optional<SimdLevel> parse_simd_level(std::string_view name) {
+  for (const auto level : {SimdLevel::scalar, SimdLevel::sse2, SimdLevel::avx2,
+                           SimdLevel::avx512}) {
+    if (simd_level_name(level) == name) { return level; }
+  }
+  return std::nullopt;
+}
+
+namespace detail {
+
+inline SimdLevel detect_simd_level() {
+#if CGFS_RUNTIME_DISPATCH
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) { return SimdLevel::avx512; }
+  if (__builtin_cpu_supports("avx2")) { return SimdLevel::avx2; }
+  if (__builtin_cpu_supports("sse2")) { return SimdLevel::sse2; }
+  return SimdLevel::scalar;
+#elif defined(__AVX512F__)
+  return SimdLevel::avx512;
+#elif defined(__AVX2__)
+  return SimdLevel::avx2;
+#elif defined(__SSE2__)
+  return SimdLevel::sse2;
+#else
+  return SimdLevel::scalar;
+#endif
+}
+
+}  // namespace detail
+
+/**
+ * @brief Best variant this CPU runs and this build has, detected once
+ */
+inline SimdLevel supported_simd_level() {
+  static const SimdLevel level = detail::detect_simd_level();
+  return level;
+}
+
+namespace detail {
+
+/**
+ * @brief The level a CGFS_SIMD value asks for, or supported if it can not be run
+ *
+ * An unknown name, or one above what the CPU supports, is reported on warnings and then
+ * ignored rather than failing at startup.
+ */
+inline SimdLevel requested_simd_level(std::string_view name, SimdLevel supported,
+                                      std::ostream& warnings) {
+  const auto requested = parse_simd_level(name);
+  if (requested.has_value() && *requested <= supported) { return *requested; }
+
+  warnings << "Ignoring CGFS_SIMD=" << name << ", "
+           << (requested.has_value() ? "this CPU or build can not run it" : "not a SIMD level")
+           << "; using " << simd_level_name(supported) << ".\n";
+  return supported;
+}
+
+/**
+ * @brief The supported level, or the one named by the CGFS_SIMD environment variable
+ */
+inline SimdLevel initial_simd_level() {
+  const auto supported = supported_simd_level();
+  const char* name = std::getenv("CGFS_SIMD");
+  if (name == nullptr) { return supported; }
+  return requested_simd_level(name, supported, std::cerr);
+}
+
+inline std::atomic<SimdLevel>& active_simd_level() {
+  static std::atomic<SimdLevel> level{initial_simd_level()};
+  return level;
+}
+
+/**
+ * @brief Kernels that bound a variant for the active level, and the lock level changes take
+ */
+struct SimdBindings {
+  std::mutex mutex;
+  std::vector<void (*)()> rebinds;
+};
+
+inline SimdBindings& simd_bindings() {
+  static SimdBindings bindings;
+  return bindings;
+}
+
+/**
+ * @brief Bind a kernel to the variant for the active level, and again after every change
+ *
+ * rebind stores the variant for simd_level() wherever the kernel's callers load it from. A
+ * kernel calls this on its first use, so callers then reach the variant through one pointer
+ * instead of looking the level up on every call.
+ */
+inline void bind_simd_kernel(void (*rebind)()) {
+  auto& bindings = simd_bindings();
+  const std::lock_guard lock{bindings.mutex};
+  if (std::find(bindings.rebinds.begin(), bindings.rebinds.end(), rebind) ==
+      bindings.rebinds.end()) {
+    bindings.rebinds.push_back(rebind);
+  }
+  rebind();
+}
+
+inline void set_simd_level(SimdLevel level) {
+  auto& bindings = simd_bindings();
+  const std::lock_guard lock{bindings.mutex};
+  active_simd_level().store(level, std::memory_order_relaxed);
+  for (const auto rebind : bindings.rebinds) { rebind(); }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Variant the kernels dispatch to
+ */
+inline SimdLevel simd_level() {
+  return detail::active_simd_level().load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Run a specific variant from now on, for testing and benchmarking
+ *
+ * Takes effect for kernels called after it returns; renders already running may mix variants,
+ * which all give the same hits.
+ *
+ * @throws std::invalid_argument if the level is above supported_simd_level()
+ */
+inline void force_simd_level(SimdLevel level) {
+  if (level > supported_simd_level()) {
+    throw std::invalid_argument("This CPU or build can not run that SIMD level.");
+  }
+  detail::set_simd_level(level);
+}
+
+/**
+ * @brief Go back to the best supported variant
+ */
+inline void reset_simd_level() {
+  detail::set_simd_level(supported_simd_level());
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_CPU_FEATURES_HPP
@@ -0,0 +1,128 @@
+/**
+ * @brief Scene whose object and light counts are only known at runtime
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_DYNAMIC_SCENE_HPP
+#define CGFS_DYNAMIC_SCENE_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Objects/Shapes.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/ShapeIntersection.hpp"
+
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace cgfs {
+
+using DynamicSceneProperties =
+    mguid::NamedTuple<mguid::NamedType<"objects", std::vector<Sphere>>,
+                      mguid::NamedType<"lights", std::vector<Light>>,
+                      mguid::NamedType<"background_color", Color3>,
+                      mguid::NamedType<"shapes", ShapeArrays>>;
+
+/**
+ * @brief A Scene with runtime sized, contiguous object and light storage
+ *
+ * Every DynamicScene is the same type, so the tracing functions are instantiated once for all of
+ * them instead of once per Scene<NumObjects, NumLights>. Inserting may reallocate, which
+ * invalidates the sphere pointers returned by earlier intersection queries.
+ *
+ * Spheres live in objects; every other primitive lives in shapes, one array per type.
+ */
+struct DynamicScene : DynamicSceneProperties {
+  explicit DynamicScene(const Color3& background_color, size_t object_capacity = 0,
+                        size_t light_capacity = 0)
+      : DynamicSceneProperties{std::vector<Sphere>{}, std::vector<Light>{}, background_color,
+                               ShapeArrays{}} {
+    reserve(object_capacity, light_capacity);
+  }
+
+  template <size_t NumObjects, size_t NumLights>
+  explicit DynamicScene(const Scene<NumObjects, NumLights>& scene)
+      : DynamicScene{scene.template get<"background_color">(), NumObjects, NumLights} {
+    insert_objects(scene.template get<"objects">());
+    insert_lights(scene.template get<"lights">());
+  }
+
+  using DynamicSceneProperties::get;
+
+  /**
+   * @brief Make room for at least this many objects and lights in total
+   */
+  void reserve(size_t object_capacity, size_t light_capacity) {
+    get<"objects">().reserve(object_capacity);
+    get<"lights">().reserve(light_capacity);
+  }
+
+  /**
+   * @brief Append objects, growing the storage at most once
+   */
+  void insert_objects(std::span<const Sphere> objects) {
+    auto& stored = get<"objects">();
+    stored.insert(stored.end(), objects.begin(), objects.end());
+  }
+
+  /**
+   * @brief Append lights, growing the storage at most once
+   */
+  void insert_lights(std::span<const Light> lights) {
+    auto& stored = get<"lights">();
+    stored.insert(stored.end(), lights.begin(), lights.end());
+  }
+
+  void add_object(const Sphere& object) { get<"objects">().push_back(object); }
+
+  void add_light(const Light& light) { get<"lights">().push_back(light); }
+
+  template <typename Shape>
+  void add_shape(Shape&& shape) {
+    cgfs::add_shape(get<"shapes">(), std::forward<Shape>(shape));
+  }
+
+  /**
+   * @brief Release capacity left over from reserving or loading
+   */
+  void shrink_to_fit() {
+    get<"objects">().shrink_to_fit();
+    get<"lights">().shrink_to_fit();
+    get<"shapes">().get<"planes">().shrink_to_fit();
+    get<"shapes">().get<"boxes">().shrink_to_fit();
+    get<"shapes">().get<"discs">().shrink_to_fit();
+    get<"shapes">().get<"triangles">().shrink_to_fit();
+    get<"shapes">().get<"meshes">().shrink_to_fit();
+    get<"shapes">().get<"instances">().shrink_to_fit();
+  }
+};
+
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const DynamicScene& scene) {
+  const auto shape_hit =
+      closest_intersection(origin, direction, t_min, t_max, scene.get<"shapes">());
+  const double sphere_t_max = is_hit(shape_hit) ? shape_hit.get<"closest_t">() : t_max;
+  return closer_hit(shape_hit,
+                    closest_intersection(origin, direction, t_min, sphere_t_max,
+                                         std::span<const Sphere>{scene.get<"objects">()}));
+}
+
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const DynamicScene& scene) {
+  return occluded(origin, direction, t_min, t_max,
+                  std::span<const Sphere>{scene.get<"objects">()}) ||
+         occluded(origin, direction, t_min, t_max, scene.get<"shapes">());
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_DYNAMIC_SCENE_HPP
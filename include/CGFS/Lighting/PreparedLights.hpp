@@ -0,0 +1,163 @@
+/**
+ * @brief Lights regrouped by type for shading loops
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_PREPARED_LIGHTS_HPP
+#define CGFS_PREPARED_LIGHTS_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Math.hpp"
+
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Point light in the scalar type of the scene that shades with it
+ */
+template <typename Scalar>
+using BasicPointLight = mguid::NamedTuple<mguid::NamedType<"intensity", Scalar>,
+                                          mguid::NamedType<"position", Vec3<Scalar>>>;
+
+/**
+ * @brief Directional light with its direction normalized once for shading
+ *
+ * Shadow rays still travel along the direction as given, since the shadow query's t_min offset
+ * is measured in units of it.
+ */
+template <typename Scalar>
+using BasicPreparedDirectionalLight =
+    mguid::NamedTuple<mguid::NamedType<"intensity", Scalar>,
+                      mguid::NamedType<"direction", Vec3<Scalar>>,
+                      mguid::NamedType<"shadow_direction", Vec3<Scalar>>>;
+
+/**
+ * @brief Point light that only reaches points within radius of its position
+ */
+template <typename Scalar>
+using BasicLocalPointLight = mguid::NamedTuple<mguid::NamedType<"intensity", Scalar>,
+                                               mguid::NamedType<"position", Vec3<Scalar>>,
+                                               mguid::NamedType<"radius", Scalar>>;
+
+using PreparedDirectionalLight = BasicPreparedDirectionalLight<double>;
+using LocalPointLight = BasicLocalPointLight<double>;
+
+/**
+ * @brief A scene's lights with per-hit work hoisted out
+ *
+ * Every ambient light is folded into one constant, and the rest are split into one array per
+ * type, so shading runs a plain loop per type instead of dispatching on each light. Point and
+ * directional lights keep their scene order within their array.
+ *
+ * Point lights given an influence radius become local lights instead. Those are stored in the
+ * leaf order of a BVH over their spheres of influence, so shading a point only visits the few
+ * whose sphere contains it, however many the scene has. The BVH stays in double whatever the
+ * scalar type of the lights.
+ */
+template <typename Scalar>
+using BasicPreparedLights =
+    mguid::NamedTuple<mguid::NamedType<"ambient", Scalar>,
+                      mguid::NamedType<"point_lights", std::vector<BasicPointLight<Scalar>>>,
+                      mguid::NamedType<"directional_lights",
+                                       std::vector<BasicPreparedDirectionalLight<Scalar>>>,
+                      mguid::NamedType<"local_lights", std::vector<BasicLocalPointLight<Scalar>>>,
+                      mguid::NamedType<"local_light_bvh", BVH>>;
+
+using PreparedLights = BasicPreparedLights<double>;
+
+/**
+ * @param lights lights to prepare
+ * @param influence_radii optional radius per light, indexed like lights; a point light with a
+ * radius below basically_infinity is ignored by points further away, the others ignore it
+ * @throws std::invalid_argument if influence_radii is neither empty nor one per light
+ */
+inline PreparedLights prepare_lights(std::span<const Light> lights,
+                                     std::span<const double> influence_radii = {}) {
+  if (!influence_radii.empty() && influence_radii.size() != lights.size()) {
+    throw std::invalid_argument("Need one influence radius per light.");
+  }
+
+  PreparedLights prepared{0.0, std::vector<PointLightProperties>{},
+                          std::vector<PreparedDirectionalLight>{},
+                          std::vector<LocalPointLight>{}, BVH{}};
+  std::vector<LocalPointLight> local_lights;
+
+  for (size_t i{0}; i < lights.size(); ++i) {
+    const double radius = influence_radii.empty() ? basically_infinity : influence_radii[i];
+    lights[i].visit(
+        [&](const AmbientLightProperties& ambient_light) {
+          prepared.get<"ambient">() += ambient_light.get<"intensity">();
+        },
+        [&](const PointLightProperties& point_light) {
+          if (radius < basically_infinity) {
+            local_lights.emplace_back(point_light.get<"intensity">(),
+                                      point_light.get<"position">(), radius);
+          } else {
+            prepared.get<"point_lights">().push_back(point_light);
+          }
+        },
+        [&](const DirectionalLightProperties& directional_light) {
+          const auto& direction = directional_light.get<"direction">();
+          prepared.get<"directional_lights">().emplace_back(
+              directional_light.get<"intensity">(), direction / length(direction), direction);
+        });
+  }
+
+  std::vector<AABB> bounds;
+  bounds.reserve(local_lights.size());
+  for (const auto& light : local_lights) {
+    const double r = light.get<"radius">();
+    bounds.emplace_back(light.get<"position">() - Vec3d{r, r, r},
+                        light.get<"position">() + Vec3d{r, r, r});
+  }
+  auto& bvh = prepared.get<"local_light_bvh">();
+  bvh = BVH{bounds};
+  for (const auto index : bvh.primitive_order()) {
+    prepared.get<"local_lights">().push_back(local_lights[index]);
+  }
+
+  return prepared;
+}
+
+/**
+ * @brief Convert prepared lights to another scalar type, light by light
+ */
+template <typename To, typename From>
+BasicPreparedLights<To> prepared_lights_cast(const BasicPreparedLights<From>& lights) {
+  BasicPreparedLights<To> converted{static_cast<To>(lights.template get<"ambient">()),
+                                    std::vector<BasicPointLight<To>>{},
+                                    std::vector<BasicPreparedDirectionalLight<To>>{},
+                                    std::vector<BasicLocalPointLight<To>>{},
+                                    lights.template get<"local_light_bvh">()};
+  for (const auto& light : lights.template get<"point_lights">()) {
+    converted.template get<"point_lights">().emplace_back(
+        static_cast<To>(light.template get<"intensity">()),
+        vec3_cast<To>(light.template get<"position">()));
+  }
+  for (const auto& light : lights.template get<"directional_lights">()) {
+    converted.template get<"directional_lights">().emplace_back(
+        static_cast<To>(light.template get<"intensity">()),
+        vec3_cast<To>(light.template get<"direction">()),
+        vec3_cast<To>(light.template get<"shadow_direction">()));
+  }
+  for (const auto& light : lights.template get<"local_lights">()) {
+    converted.template get<"local_lights">().emplace_back(
+        static_cast<To>(light.template get<"intensity">()),
+        vec3_cast<To>(light.template get<"position">()),
+        static_cast<To>(light.template get<"radius">()));
+  }
+  return converted;
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_PREPARED_LIGHTS_HPP
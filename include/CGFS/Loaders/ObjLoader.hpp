@@ -0,0 +1,355 @@
+/**
+ * @brief Parallel Wavefront OBJ loading into mesh buffers
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_OBJ_LOADER_HPP
+#define CGFS_OBJ_LOADER_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/AlignedAllocator.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Objects/Mesh.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace cgfs {
+
+/**
+ * @brief Geometry of an OBJ file, ready to become a TriangleMesh
+ *
+ * Polygons are fan triangulated. face_materials indexes material_names, which holds the usemtl
+ * names in order of first use; entry 0 is the empty name, used by faces before any usemtl.
+ */
+using ObjMeshData = mguid::NamedTuple<mguid::NamedType<"positions", AlignedVector<Vec3d>>,
+                                      mguid::NamedType<"indices", AlignedVector<uint32_t>>,
+                                      mguid::NamedType<"face_materials", AlignedVector<uint32_t>>,
+                                      mguid::NamedType<"material_names", std::vector<std::string>>>;
+
+/**
+ * @brief Smallest slice of a file handed to one parse task
+ */
+constexpr size_t min_obj_chunk_size = size_t{1} << 16;
+
+namespace detail {
+
+/**
+ * @brief Read only view of a whole file, memory mapped where the platform allows it
+ */
+class MappedFile {
+public:
+  explicit MappedFile(const std::filesystem::path& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    m_descriptor = ::open(path.c_str(), O_RDONLY);
+    if (m_descriptor < 0) { throw std::runtime_error("Failed to open " + path.string()); }
+
+    struct stat info{};
+    if (::fstat(m_descriptor, &info) != 0) {
+      ::close(m_descriptor);
+      throw std::runtime_error("Failed to stat " + path.string());
+    }
+    m_size = static_cast<size_t>(info.st_size);
+    if (m_size == 0) { return; }
+
+    void* mapping = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, m_descriptor, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(m_descriptor);
+      throw std::runtime_error("Failed to map " + path.string());
+    }
+    m_data = static_cast<const char*>(mapping);
+#else
+    std::ifstream file{path, std::ios::binary};
+    if (!file) { throw std::runtime_error("Failed to open " + path.string()); }
+    m_buffer.assign(std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{});
+    m_data = m_buffer.data();
+    m_size = m_buffer.size();
+#endif
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (m_data != nullptr) { ::munmap(const_cast<char*>(m_data), m_size); }
+    ::close(m_descriptor);
+#endif
+  }
+
+  [[nodiscard]] std::string_view contents() const { return {m_data, m_size}; }
+
+private:
+  const char* m_data{nullptr};
+  size_t m_size{0};
+#if defined(__unix__) || defined(__APPLE__)
+  int m_descriptor{-1};
+#else
+  std::string m_buffer;
+#endif
+};
+
+/**
+ * @brief One slice of the file and what the first pass learned about it
+ */
+struct ObjChunk {
+  std::string_view text;
+  uint32_t vertex_count{0};
+  uint32_t triangle_count{0};
+  std::vector<std::string_view> usemtl_names;
+
+  // Filled in between the passes
+  uint32_t first_vertex{0};
+  uint32_t first_triangle{0};
+  uint32_t start_material{0};
+  std::vector<uint32_t> usemtl_ids;
+};
+
+constexpr bool is_blank(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+constexpr std::string_view trim(std::string_view text) {
+  while (!text.empty() && is_blank(text.front())) { text.remove_prefix(1); }
+  while (!text.empty() && is_blank(text.back())) { text.remove_suffix(1); }
+  return text;
+}
+
+/**
+ * @brief If line is keyword followed by whitespace, strip both and return true
+ */
+constexpr bool consume_keyword(std::string_view& line, std::string_view keyword) {
+  if (line.size() <= keyword.size() || line.substr(0, keyword.size()) != keyword ||
+      !is_blank(line[keyword.size()])) {
+    return false;
+  }
+  line = trim(line.substr(keyword.size()));
+  return true;
+}
+
+/**
+ * @brief Split the next whitespace separated token off the front of text
+ */
+constexpr std::string_view next_token(std::string_view& text) {
+  text = trim(text);
+  const auto end = std::min(text.find_first_of(" \t\r"), text.size());
+  const auto token = text.substr(0, end);
+  text.remove_prefix(end);
+  return token;
+}
+
+template <typename LineVisitor>
+void for_each_line(std::string_view text, LineVisitor&& visit_line) {
+  while (!text.empty()) {
+    const auto end = std::min(text.find('\n'), text.size());
+    visit_line(trim(text.substr(0, end)));
+    text.remove_prefix(std::min(end + 1, text.size()));
+  }
+}
+
+[[noreturn]] inline void malformed_obj(std::string_view line) {
+  throw std::runtime_error("Malformed OBJ line: " + std::string{line});
+}
+
+/**
+ * @brief Split text into about count slices, each ending just after a newline
+ */
+inline std::vector<ObjChunk> split_obj(std::string_view text, size_t count) {
+  std::vector<ObjChunk> chunks;
+  size_t begin = 0;
+  for (size_t i{1}; i <= count && begin < text.size(); ++i) {
+    size_t end = i == count ? text.size() : std::max(begin, i * text.size() / count);
+    end = std::min(text.find('\n', end), text.size());
+    end = std::min(end + 1, text.size());
+    auto& chunk = chunks.emplace_back();
+    chunk.text = text.substr(begin, end - begin);
+    begin = end;
+  }
+  return chunks;
+}
+
+/**
+ * @brief First pass: count vertices and triangles and collect usemtl names
+ */
+inline void scan_obj_chunk(ObjChunk& chunk) {
+  for_each_line(chunk.text, [&](std::string_view line) {
+    const auto full_line = line;
+
+    if (consume_keyword(line, "v")) {
+      ++chunk.vertex_count;
+    } else if (consume_keyword(line, "f")) {
+      uint32_t corners = 0;
+      while (!next_token(line).empty()) { ++corners; }
+      if (corners < 3) { malformed_obj(full_line); }
+      chunk.triangle_count += corners - 2;
+    } else if (consume_keyword(line, "usemtl")) {
+      chunk.usemtl_names.push_back(line);
+    }
+  });
+}
+
+/**
+ * @brief Resolve one face corner, "v", "v/vt", "v//vn" or "v/vt/vn", to a 0 based vertex index
+ * @param vertices_so_far vertices defined before this line, for negative relative indices
+ */
+inline uint32_t parse_corner(std::string_view token, uint32_t vertices_so_far,
+                             std::string_view line) {
+  int64_t index = 0;
+  const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), index);
+  if (error != std::errc{} || (end != token.data() + token.size() && *end != '/')) {
+    malformed_obj(line);
+  }
+
+  const int64_t resolved = index > 0 ? index - 1 : static_cast<int64_t>(vertices_so_far) + index;
+  if (index == 0 || resolved < 0) { malformed_obj(line); }
+  return static_cast<uint32_t>(resolved);
+}
+
+/**
+ * @brief Second pass: parse a chunk straight into its slots of the final buffers
+ */
+inline void parse_obj_chunk(const ObjChunk& chunk, ObjMeshData& data) {
+  auto* positions = data.get<"positions">().data();
+  auto* indices = data.get<"indices">().data();
+  auto* face_materials = data.get<"face_materials">().data();
+
+  uint32_t vertex = chunk.first_vertex;
+  uint32_t triangle = chunk.first_triangle;
+  uint32_t material = chunk.start_material;
+  size_t usemtl = 0;
+
+  for_each_line(chunk.text, [&](std::string_view line) {
+    const auto full_line = line;
+
+    if (consume_keyword(line, "v")) {
+      std::array<double, 3> xyz{};
+      for (auto& value : xyz) {
+        const auto token = next_token(line);
+        const auto [end, error] =
+            std::from_chars(token.data(), token.data() + token.size(), value);
+        if (token.empty() || error != std::errc{} || end != token.data() + token.size()) {
+          malformed_obj(full_line);
+        }
+      }
+      positions[vertex++] = Vec3d{xyz[0], xyz[1], xyz[2]};
+    } else if (consume_keyword(line, "f")) {
+      const uint32_t first = parse_corner(next_token(line), vertex, full_line);
+      uint32_t previous = parse_corner(next_token(line), vertex, full_line);
+      for (auto token = next_token(line); !token.empty(); token = next_token(line)) {
+        const uint32_t current = parse_corner(token, vertex, full_line);
+        indices[3 * size_t{triangle}] = first;
+        indices[3 * size_t{triangle} + 1] = previous;
+        indices[3 * size_t{triangle} + 2] = current;
+        face_materials[triangle++] = material;
+        previous = current;
+      }
+    } else if (consume_keyword(line, "usemtl")) {
+      material = chunk.usemtl_ids[usemtl++];
+    }
+  });
+}
+
+}  // namespace detail
+
+/**
+ * @brief Parse OBJ text in parallel
+ *
+ * The text is cut into chunks on line boundaries. A first parallel pass counts the vertices and
+ * triangles of every chunk, which fixes where each chunk's output goes; the buffers are then
+ * allocated once at their final size and a second parallel pass parses every chunk straight
+ * into its slots. Numbers are read in place with from_chars, so no token is ever copied.
+ *
+ * Only v, f and usemtl lines are read; everything else is skipped.
+ *
+ * @throws std::runtime_error on a line that cannot be parsed
+ */
+inline ObjMeshData parse_obj(std::string_view text, ThreadPool& pool) {
+  const size_t chunk_count =
+      std::clamp(text.size() / min_obj_chunk_size, size_t{1}, 4 * pool.size());
+  auto chunks = detail::split_obj(text, chunk_count);
+
+  pool.parallel_for(chunks.size(), [&](size_t i) { detail::scan_obj_chunk(chunks[i]); });
+
+  // Assign output ranges and material ids in file order
+  std::vector<std::string> material_names{std::string{}};
+  std::unordered_map<std::string_view, uint32_t> material_ids;
+  uint64_t vertex_total = 0;
+  uint64_t triangle_total = 0;
+  uint32_t material = 0;
+  for (auto& chunk : chunks) {
+    chunk.first_vertex = static_cast<uint32_t>(vertex_total);
+    chunk.first_triangle = static_cast<uint32_t>(triangle_total);
+    chunk.start_material = material;
+    vertex_total += chunk.vertex_count;
+    triangle_total += chunk.triangle_count;
+
+    for (const auto name : chunk.usemtl_names) {
+      const auto [entry, inserted] =
+          material_ids.try_emplace(name, static_cast<uint32_t>(material_names.size()));
+      if (inserted) { material_names.emplace_back(name); }
+      material = entry->second;
+      chunk.usemtl_ids.push_back(material);
+    }
+  }
+  if (vertex_total > UINT32_MAX || 3 * triangle_total > UINT32_MAX) {
+    throw std::runtime_error("OBJ file is too large for 32 bit indices.");
+  }
+
+  ObjMeshData data{AlignedVector<Vec3d>(vertex_total),
+                   AlignedVector<uint32_t>(3 * triangle_total),
+                   AlignedVector<uint32_t>(triangle_total), std::move(material_names)};
+
+  pool.parallel_for(chunks.size(), [&](size_t i) { detail::parse_obj_chunk(chunks[i], data); });
+
+  return data;
+}
+
+/**
+ * @brief Memory map an OBJ file and parse it in parallel
+ * @throws std::runtime_error if the file cannot be read or parsed
+ */
+inline ObjMeshData load_obj(const std::filesystem::path& path, ThreadPool& pool) {
+  const detail::MappedFile file{path};
+  return parse_obj(file.contents(), pool);
+}
+
+/**
+ * @brief Build a mesh from loaded OBJ data, moving its buffers
+ * @param data loaded geometry
+ * @param material_for callable mapping a usemtl name, "" for none, to MaterialProperties
+ */
+template <typename MaterialLookup>
+TriangleMesh to_mesh(ObjMeshData data, MaterialLookup&& material_for) {
+  std::vector<MaterialProperties> materials;
+  materials.reserve(data.get<"material_names">().size());
+  for (const auto& name : data.get<"material_names">()) {
+    materials.push_back(material_for(std::string_view{name}));
+  }
+
+  return TriangleMesh{std::move(data.get<"positions">()), std::move(data.get<"indices">()),
+                      std::move(data.get<"face_materials">()), std::move(materials)};
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_OBJ_LOADER_HPP
@@ -0,0 +1,142 @@
+/**
+ * @brief Scalar and vector math helpers shared by the tracer
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_MATH_HPP
+#define CGFS_MATH_HPP
+
+#include "CGFS/Common.hpp"
+
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <type_traits>
+
+namespace cgfs {
+
+template <typename T>
+constexpr T sqrtNewtonRaphson(T x, T current, T prev) {
+  return (current == prev)
+             ? current
+             : sqrtNewtonRaphson(x, static_cast<T>(0.5 * (current + x / current)), current);
+}
+
+/**
+ * @brief Square root usable in constant expressions
+ *
+ * Constant evaluation runs Newton-Raphson to convergence; at runtime this is std::sqrt, a single
+ * correctly rounded instruction on every target we build for.
+ */
+template <typename T>
+constexpr T sqrt(T x) {
+  static_assert(std::is_arithmetic_v<T>, "sqrt only supports arithmetic types.");
+  if (!(x >= 0)) { throw std::runtime_error("Square root of a negative number!"); }
+  if (std::is_constant_evaluated()) { return sqrtNewtonRaphson(x, x, T{}); }
+  return static_cast<T>(std::sqrt(x));
+}
+
+template <typename Type>
+constexpr Type dot(const Vec3<Type>& a, const Vec3<Type>& b) {
+  return (a.template get<"x">() * b.template get<"x">()) +
+         (a.template get<"y">() * b.template get<"y">()) +
+         (a.template get<"z">() * b.template get<"z">());
+}
+
+template <typename Type>
+constexpr Vec3<Type> cross(const Vec3<Type>& a, const Vec3<Type>& b) {
+  return Vec3<Type>{a.template get<"y">() * b.template get<"z">() -
+                        a.template get<"z">() * b.template get<"y">(),
+                    a.template get<"z">() * b.template get<"x">() -
+                        a.template get<"x">() * b.template get<"z">(),
+                    a.template get<"x">() * b.template get<"y">() -
+                        a.template get<"y">() * b.template get<"x">()};
+}
+
+/**
+ * @brief Power usable in constant expressions
+ *
+ * Constant evaluation multiplies once per unit of exp, so it needs an integral valued exponent;
+ * at runtime this is std::pow, which takes any exponent in constant time.
+ */
+template <typename Base, typename Exponent>
+constexpr Base constexprPow(Base base, Exponent exp)
+  requires std::is_arithmetic_v<Base> && std::is_arithmetic_v<Exponent>
+{
+  if (!std::is_constant_evaluated()) { return static_cast<Base>(std::pow(base, exp)); }
+  return (exp == 0)  ? static_cast<Base>(1)
+         : (exp > 0) ? base * constexprPow(base, exp - 1)
+                     : static_cast<Base>(1) / constexprPow(base, -exp);
+}
+
+constexpr double length(const Vec3d& vec) {
+  return sqrt(vec.get<"x">() * vec.get<"x">() + vec.get<"y">() * vec.get<"y">() +
+              vec.get<"z">() * vec.get<"z">());
+}
+
+constexpr float length(const Vec3f& vec) {
+  return sqrt(vec.get<"x">() * vec.get<"x">() + vec.get<"y">() * vec.get<"y">() +
+              vec.get<"z">() * vec.get<"z">());
+}
+
+constexpr Mat3d transpose(const Mat3d& mat) {
+  Mat3d result;
+  for (size_t i = 0; i < 3; i++) {
+    for (size_t j = 0; j < 3; j++) { result[i][j] = mat[j][i]; }
+  }
+  return result;
+}
+
+constexpr double determinant(const Mat3d& m) {
+  return m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+         m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+         m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+}
+
+/**
+ * @brief Inverse by the adjugate; the caller checks the determinant is not zero
+ */
+constexpr Mat3d inverse(const Mat3d& m) {
+  const double inv_det = 1.0 / determinant(m);
+  return Mat3d{std::array{(m[1][1] * m[2][2] - m[1][2] * m[2][1]) * inv_det,
+                          (m[0][2] * m[2][1] - m[0][1] * m[2][2]) * inv_det,
+                          (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inv_det},
+               std::array{(m[1][2] * m[2][0] - m[1][0] * m[2][2]) * inv_det,
+                          (m[0][0] * m[2][2] - m[0][2] * m[2][0]) * inv_det,
+                          (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inv_det},
+               std::array{(m[1][0] * m[2][1] - m[1][1] * m[2][0]) * inv_det,
+                          (m[0][1] * m[2][0] - m[0][0] * m[2][1]) * inv_det,
+                          (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inv_det}};
+}
+
+constexpr Vec3d reflect_ray(const Vec3d& ray, const Vec3d normal) {
+  return 2.0 * normal * dot(normal, ray) - ray;
+}
+
+constexpr Vec3f reflect_ray(const Vec3f& ray, const Vec3f normal) {
+  return 2.0F * normal * dot(normal, ray) - ray;
+}
+
+/**
+ * @brief Whether a * t^2 + 2 * half_b * t + c, with a > 0, has a root inside (t_min, t_max)
+ *
+ * Decided from the sign of the polynomial at both ends of the interval, so unlike solving for the
+ * roots it needs no sqrt and no division. NaN coefficients never report a root.
+ */
+template <typename T>
+constexpr bool quadratic_has_root_between(T a, T half_b, T c, T t_min, T t_max) {
+  const T at_min = (a * t_min + T{2} * half_b) * t_min + c;
+  const T at_max = (a * t_max + T{2} * half_b) * t_max + c;
+
+  // A sign change between the ends means exactly one root in between
+  if ((at_min < T{0}) != (at_max < T{0})) { return (at_min == at_min) && (at_max == at_max); }
+
+  // Both ends positive: the roots fall between them only if the vertex does and they are real
+  return at_min > T{0} && at_max > T{0} && -half_b > a * t_min && -half_b < a * t_max &&
+         half_b * half_b - a * c >= T{0};
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_MATH_HPP
@@ -0,0 +1,214 @@
+/**
+ * @brief Shared geometry placed many times through lightweight instances
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_INSTANCE_HPP
+#define CGFS_INSTANCE_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Mesh.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Affine map from an instance's object space to world space, with its inverse
+ *
+ * world = linear * object + translation. The inverse is stored because every ray is mapped the
+ * other way, into object space.
+ */
+using Transform = mguid::NamedTuple<mguid::NamedType<"linear", Mat3d>,
+                                    mguid::NamedType<"inverse_linear", Mat3d>,
+                                    mguid::NamedType<"translation", Vec3d>>;
+
+/**
+ * @throws std::invalid_argument if linear cannot be inverted
+ */
+constexpr Transform make_transform(const Mat3d& linear, const Vec3d& translation) {
+  if (determinant(linear) == 0.0) {
+    throw std::invalid_argument("Instance transform must be invertible.");
+  }
+  return Transform{linear, inverse(linear), translation};
+}
+
+constexpr Transform make_transform(const Vec3d& translation) {
+  const Mat3d identity{std::array{1.0, 0.0, 0.0}, std::array{0.0, 1.0, 0.0},
+                       std::array{0.0, 0.0, 1.0}};
+  return Transform{identity, identity, translation};
+}
+
+constexpr Vec3d to_world_point(const Transform& transform, const Vec3d& point) {
+  return transform.get<"linear">() * point + transform.get<"translation">();
+}
+
+constexpr Vec3d to_object_point(const Transform& transform, const Vec3d& point) {
+  return transform.get<"inverse_linear">() * (point - transform.get<"translation">());
+}
+
+constexpr Vec3d to_object_direction(const Transform& transform, const Vec3d& direction) {
+  return transform.get<"inverse_linear">() * direction;
+}
+
+/**
+ * @brief Map an object space normal to a unit world space normal, by the inverse transpose
+ */
+constexpr Vec3d to_world_normal(const Transform& transform, const Vec3d& normal) {
+  const auto world = transpose(transform.get<"inverse_linear">()) * normal;
+  return world / length(world);
+}
+
+/**
+ * @brief World bounds of a transformed box, from its eight corners; empty boxes stay empty
+ */
+constexpr AABB to_world_bounds(const Transform& transform, const AABB& box) {
+  const auto& lo = box.get<"min">();
+  const auto& hi = box.get<"max">();
+  if (lo.get<"x">() > hi.get<"x">()) { return box; }
+
+  AABB bounds = empty_aabb();
+  for (unsigned corner{0}; corner < 8; ++corner) {
+    const Vec3d point{(corner & 1U) != 0 ? hi.get<"x">() : lo.get<"x">(),
+                      (corner & 2U) != 0 ? hi.get<"y">() : lo.get<"y">(),
+                      (corner & 4U) != 0 ? hi.get<"z">() : lo.get<"z">()};
+    bounds = merge(bounds, to_world_point(transform, point));
+  }
+  return bounds;
+}
+
+/**
+ * @brief Geometry built once and shared by every instance that places it
+ *
+ * Spheres are stored in BVH leaf order and mirrored into a SphereSoA, like a compiled scene;
+ * meshes bring their own BVH. All of it lives in object space.
+ */
+class InstanceGeometry {
+public:
+  InstanceGeometry() = default;
+
+  explicit InstanceGeometry(const std::vector<Sphere>& spheres,
+                            std::vector<TriangleMesh> meshes = {})
+      : m_meshes{std::move(meshes)} {
+    std::vector<AABB> sphere_bounds;
+    sphere_bounds.reserve(spheres.size());
+    for (const auto& sphere : spheres) {
+      sphere_bounds.push_back(bounds_of(sphere));
+      m_bounds = merge(m_bounds, sphere_bounds.back());
+    }
+    m_bvh = BVH{sphere_bounds};
+
+    m_spheres.reserve(spheres.size());
+    for (const auto index : m_bvh.primitive_order()) { m_spheres.push_back(spheres[index]); }
+    m_sphere_soa = SphereSoA{m_spheres};
+
+    for (const auto& mesh : m_meshes) {
+      if (!mesh.bvh().empty()) {
+        m_bounds = merge(m_bounds, mesh.bvh().nodes().front().get<"bounds">());
+      }
+    }
+  }
+
+  [[nodiscard]] const std::vector<Sphere>& spheres() const { return m_spheres; }
+  [[nodiscard]] const SphereSoA& sphere_soa() const { return m_sphere_soa; }
+  [[nodiscard]] const BVH& bvh() const { return m_bvh; }
+  [[nodiscard]] const std::vector<TriangleMesh>& meshes() const { return m_meshes; }
+
+  /**
+   * @brief Object space bounds of everything in the geometry
+   */
+  [[nodiscard]] const AABB& bounds() const { return m_bounds; }
+
+private:
+  std::vector<Sphere> m_spheres;
+  SphereSoA m_sphere_soa;
+  BVH m_bvh;
+  std::vector<TriangleMesh> m_meshes;
+  AABB m_bounds{empty_aabb()};
+};
+
+constexpr uint32_t no_material_override = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief One placement of a shared geometry
+ *
+ * material indexes the owning InstanceSet's material table and replaces every material of the
+ * geometry, or is no_material_override to keep them.
+ */
+using Instance = mguid::NamedTuple<mguid::NamedType<"geometry", uint32_t>,
+                                   mguid::NamedType<"transform", Transform>,
+                                   mguid::NamedType<"material", uint32_t>>;
+
+/**
+ * @brief Shared geometries, the instances placing them and a top level BVH over the instances
+ *
+ * Each geometry and its BVH is built once however often it is placed; an instance only costs its
+ * record and one leaf of the top level tree, which is built over instance bounds. Instances are
+ * stored in leaf order. The set is immutable after construction.
+ */
+class InstanceSet {
+public:
+  InstanceSet() = default;
+
+  /**
+   * @throws std::invalid_argument if an instance refers past the geometries or the materials
+   */
+  InstanceSet(std::vector<InstanceGeometry> geometries, const std::vector<Instance>& instances,
+              std::vector<MaterialProperties> materials = {})
+      : m_geometries{std::move(geometries)}, m_materials{std::move(materials)} {
+    std::vector<AABB> instance_bounds;
+    instance_bounds.reserve(instances.size());
+    for (const auto& instance : instances) {
+      if (instance.get<"geometry">() >= m_geometries.size()) {
+        throw std::invalid_argument("Instance refers past the geometry table.");
+      }
+      if (instance.get<"material">() != no_material_override &&
+          instance.get<"material">() >= m_materials.size()) {
+        throw std::invalid_argument("Instance refers past the material table.");
+      }
+      instance_bounds.push_back(to_world_bounds(
+          instance.get<"transform">(), m_geometries[instance.get<"geometry">()].bounds()));
+    }
+    m_tlas = BVH{instance_bounds};
+
+    m_instances.reserve(instances.size());
+    for (const auto index : m_tlas.primitive_order()) { m_instances.push_back(instances[index]); }
+  }
+
+  [[nodiscard]] const std::vector<InstanceGeometry>& geometries() const { return m_geometries; }
+  [[nodiscard]] const std::vector<MaterialProperties>& materials() const { return m_materials; }
+  [[nodiscard]] const BVH& tlas() const { return m_tlas; }
+
+  /**
+   * @brief Instances in top level leaf order
+   */
+  [[nodiscard]] const std::vector<Instance>& instances() const { return m_instances; }
+
+  [[nodiscard]] const InstanceGeometry& geometry_of(const Instance& instance) const {
+    return m_geometries[instance.get<"geometry">()];
+  }
+
+private:
+  std::vector<InstanceGeometry> m_geometries;
+  std::vector<MaterialProperties> m_materials;
+  std::vector<Instance> m_instances;
+  BVH m_tlas;
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_INSTANCE_HPP
@@ -0,0 +1,124 @@
+/**
+ * @brief Indexed triangle meshes with their own BVH
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_MESH_HPP
+#define CGFS_MESH_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/AlignedAllocator.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Material/Material.hpp"
+
+#include <array>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Triangles sharing a vertex buffer, each face with its own material index
+ *
+ * Face f is positions[indices[3f]], positions[indices[3f + 1]], positions[indices[3f + 2]] made
+ * of materials[face_materials[f]]. Faces are visible from both sides and shaded flat.
+ *
+ * Construction builds a BVH over the faces and copies their vertices, in leaf order, into one
+ * aligned stream per vertex and axis, which is what the intersection kernel reads. The mesh is
+ * immutable afterwards.
+ */
+class TriangleMesh {
+public:
+  TriangleMesh() = default;
+
+  /**
+   * @throws std::invalid_argument if the buffers do not describe a valid mesh
+   */
+  TriangleMesh(AlignedVector<Vec3d> positions, AlignedVector<uint32_t> indices,
+               AlignedVector<uint32_t> face_materials, std::vector<MaterialProperties> materials)
+      : m_positions{std::move(positions)},
+        m_indices{std::move(indices)},
+        m_face_materials{std::move(face_materials)},
+        m_materials{std::move(materials)} {
+    if (m_indices.size() % 3 != 0) {
+      throw std::invalid_argument("Mesh index count must be a multiple of three.");
+    }
+    if (m_face_materials.size() != face_count()) {
+      throw std::invalid_argument("Mesh needs exactly one material index per face.");
+    }
+    for (const auto index : m_indices) {
+      if (index >= m_positions.size()) {
+        throw std::invalid_argument("Mesh index refers past the vertex buffer.");
+      }
+    }
+    for (const auto material : m_face_materials) {
+      if (material >= m_materials.size()) {
+        throw std::invalid_argument("Mesh face refers past the material table.");
+      }
+    }
+
+    std::vector<AABB> bounds;
+    bounds.reserve(face_count());
+    for (size_t face{0}; face < face_count(); ++face) {
+      bounds.push_back(merge(merge(AABB{vertex(face, 0), vertex(face, 0)}, vertex(face, 1)),
+                             vertex(face, 2)));
+    }
+    m_bvh = BVH{bounds};
+
+    for (auto& axis_streams : m_streams) {
+      for (auto& stream : axis_streams) { stream.resize(face_count()); }
+    }
+    const auto& order = m_bvh.primitive_order();
+    for (size_t slot{0}; slot < order.size(); ++slot) {
+      for (size_t corner{0}; corner < 3; ++corner) {
+        const auto& position = vertex(order[slot], corner);
+        m_streams[corner][0][slot] = position.get<"x">();
+        m_streams[corner][1][slot] = position.get<"y">();
+        m_streams[corner][2][slot] = position.get<"z">();
+      }
+    }
+  }
+
+  [[nodiscard]] size_t face_count() const { return m_indices.size() / 3; }
+
+  [[nodiscard]] const Vec3d& vertex(size_t face, size_t corner) const {
+    return m_positions[m_indices[3 * face + corner]];
+  }
+
+  [[nodiscard]] const MaterialProperties& face_material(size_t face) const {
+    return m_materials[m_face_materials[face]];
+  }
+
+  [[nodiscard]] const AlignedVector<Vec3d>& positions() const { return m_positions; }
+  [[nodiscard]] const AlignedVector<uint32_t>& indices() const { return m_indices; }
+  [[nodiscard]] const AlignedVector<uint32_t>& face_materials() const { return m_face_materials; }
+  [[nodiscard]] const std::vector<MaterialProperties>& materials() const { return m_materials; }
+  [[nodiscard]] const BVH& bvh() const { return m_bvh; }
+
+  /**
+   * @brief Leaf ordered coordinates of one corner of every face along one axis
+   * @param corner 0, 1 or 2
+   * @param axis 0 for x, 1 for y, 2 for z
+   */
+  [[nodiscard]] const double* corner_stream(size_t corner, size_t axis) const {
+    return m_streams[corner][axis].data();
+  }
+
+private:
+  AlignedVector<Vec3d> m_positions;
+  AlignedVector<uint32_t> m_indices;
+  AlignedVector<uint32_t> m_face_materials;
+  std::vector<MaterialProperties> m_materials;
+  BVH m_bvh;
+  std::array<std::array<AlignedVector<double>, 3>, 3> m_streams;
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_MESH_HPP
@@ -0,0 +1,90 @@
+/**
+ * @brief Non-sphere primitives and the per-type arrays scenes keep them in
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_SHAPES_HPP
+#define CGFS_SHAPES_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Common.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Objects/Instance.hpp"
+#include "CGFS/Objects/Mesh.hpp"
+
+#include <utility>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief Infinite plane of points p with dot(normal, p) == offset, visible from both sides
+ */
+using Plane = mguid::NamedTuple<mguid::NamedType<"normal", Vec3d>,
+                                mguid::NamedType<"offset", double>,
+                                mguid::NamedType<"material", MaterialProperties>>;
+
+/**
+ * @brief Axis aligned box
+ */
+using Box = mguid::NamedTuple<mguid::NamedType<"min", Vec3d>, mguid::NamedType<"max", Vec3d>,
+                              mguid::NamedType<"material", MaterialProperties>>;
+
+/**
+ * @brief Flat disc facing along normal, visible from both sides
+ */
+using Disc = mguid::NamedTuple<mguid::NamedType<"center", Vec3d>,
+                               mguid::NamedType<"normal", Vec3d>,
+                               mguid::NamedType<"radius", double>,
+                               mguid::NamedType<"material", MaterialProperties>>;
+
+/**
+ * @brief Single triangle, visible from both sides
+ */
+using Triangle = mguid::NamedTuple<mguid::NamedType<"v0", Vec3d>, mguid::NamedType<"v1", Vec3d>,
+                                   mguid::NamedType<"v2", Vec3d>,
+                                   mguid::NamedType<"material", MaterialProperties>>;
+
+/**
+ * @brief Every non-sphere primitive of a scene, one homogeneous array per type
+ *
+ * Intersection runs one loop per array, so a shape kind costs nothing per ray beyond its own
+ * loop and there is no per-object dispatch. Meshes bring their own BVH, and instance sets their
+ * top level BVH over instances of shared geometry.
+ */
+using ShapeArrays = mguid::NamedTuple<mguid::NamedType<"planes", std::vector<Plane>>,
+                                      mguid::NamedType<"boxes", std::vector<Box>>,
+                                      mguid::NamedType<"discs", std::vector<Disc>>,
+                                      mguid::NamedType<"triangles", std::vector<Triangle>>,
+                                      mguid::NamedType<"meshes", std::vector<TriangleMesh>>,
+                                      mguid::NamedType<"instances", std::vector<InstanceSet>>>;
+
+constexpr void add_shape(ShapeArrays& shapes, const Plane& plane) {
+  shapes.get<"planes">().push_back(plane);
+}
+
+constexpr void add_shape(ShapeArrays& shapes, const Box& box) {
+  shapes.get<"boxes">().push_back(box);
+}
+
+constexpr void add_shape(ShapeArrays& shapes, const Disc& disc) {
+  shapes.get<"discs">().push_back(disc);
+}
+
+constexpr void add_shape(ShapeArrays& shapes, const Triangle& triangle) {
+  shapes.get<"triangles">().push_back(triangle);
+}
+
+inline void add_shape(ShapeArrays& shapes, TriangleMesh mesh) {
+  shapes.get<"meshes">().push_back(std::move(mesh));
+}
+
+inline void add_shape(ShapeArrays& shapes, InstanceSet instances) {
+  shapes.get<"instances">().push_back(std::move(instances));
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_SHAPES_HPP
@@ -0,0 +1,135 @@
+/**
+ * @brief Compile-time precision policies for the shading math
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_PRECISION_HPP
+#define CGFS_PRECISION_HPP
+
+#include "CGFS/Common.hpp"
+#include "CGFS/Math.hpp"
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace cgfs {
+
+/**
+ * @brief Shading math as the tracer has always done it, the default policy
+ *
+ * A policy provides length, normalize and pow. Shading code is templated on the policy, so the
+ * choice costs nothing at runtime and the exact policy produces the same bits as before. The
+ * exact policy also serves the single precision path.
+ */
+struct ExactMath {
+  static constexpr double length(const Vec3d& vec) { return cgfs::length(vec); }
+  static constexpr float length(const Vec3f& vec) { return cgfs::length(vec); }
+
+  static constexpr Vec3d normalize(const Vec3d& vec) { return vec / cgfs::length(vec); }
+  static constexpr Vec3f normalize(const Vec3f& vec) { return vec / cgfs::length(vec); }
+
+  static constexpr double pow(double base, double exp) { return constexprPow(base, exp); }
+  static constexpr float pow(float base, float exp) { return constexprPow(base, exp); }
+};
+
+namespace detail {
+
+/**
+ * @brief Reciprocal square root from a bit level first guess and two Newton steps
+ *
+ * The first guess is within 3.5% of 1 / sqrt(x) for any positive normal x. Each step squares
+ * the relative error and scales it by 1.5, so after two the result is below the true value by
+ * a relative 5e-6 at most.
+ */
+inline double fast_rsqrt(double x) {
+  const double half_x = 0.5 * x;
+  double y = std::bit_cast<double>(0x5FE6EB50C7B537A9ULL - (std::bit_cast<uint64_t>(x) >> 1U));
+  y = y * (1.5 - half_x * y * y);
+  y = y * (1.5 - half_x * y * y);
+  return y;
+}
+
+/**
+ * @brief Base 2 logarithm of a positive normal x, absolute error below 2e-9
+ *
+ * Splits x into 2^e * m with m in [sqrt(1/2), sqrt(2)) and sums the atanh series of m to the
+ * ninth power, whose argument is then at most 0.172.
+ */
+inline double fast_log2(double x) {
+  const auto bits = std::bit_cast<uint64_t>(x);
+  auto exponent = static_cast<int64_t>((bits >> 52U) & 0x7FFU) - 1023;
+  double m = std::bit_cast<double>((bits & 0x000FFFFFFFFFFFFFULL) | 0x3FF0000000000000ULL);
+  if (m > 1.4142135623730951) {
+    m *= 0.5;
+    ++exponent;
+  }
+
+  // log2(m) = 2 / ln(2) * atanh(t), atanh(t) = t + t^3 / 3 + t^5 / 5 + ...
+  const double t = (m - 1.0) / (m + 1.0);
+  const double t2 = t * t;
+  constexpr double c = 2.8853900817779268;  // 2 / ln(2)
+  const double series =
+      t * (c + t2 * (c / 3.0 + t2 * (c / 5.0 + t2 * (c / 7.0 + t2 * (c / 9.0)))));
+  return static_cast<double>(exponent) + series;
+}
+
+/**
+ * @brief 2^y, relative error below 1e-8; results below the normal range flush to zero
+ *
+ * Rounds y to an integer n applied through the exponent bits and covers the remaining
+ * f in [-0.5, 0.5] with the degree 7 Taylor polynomial of e^(f ln 2).
+ */
+inline double fast_exp2(double y) {
+  if (y < -1022.0) { return 0.0; }
+  if (y > 1023.0) { return std::numeric_limits<double>::infinity(); }
+
+  const double n = std::floor(y + 0.5);
+  const double u = (y - n) * 0.6931471805599453;  // f * ln(2)
+  const double poly =
+      1.0 +
+      u * (1.0 +
+           u * (1.0 / 2.0 +
+                u * (1.0 / 6.0 +
+                     u * (1.0 / 24.0 +
+                          u * (1.0 / 120.0 + u * (1.0 / 720.0 + u * (1.0 / 5040.0)))))));
+  const auto scale = std::bit_cast<double>(static_cast<uint64_t>(static_cast<int64_t>(n) + 1023)
+                                           << 52U);
+  return poly * scale;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Approximate shading math for preview renders
+ *
+ * Error bounds, relative to the exact policy:
+ * - length and normalize: below 5e-6, from one fast reciprocal square root with two Newton
+ *   steps, and always on the short side.
+ * - pow: below 1e-8 * (1 + |exp|) for a positive base, through 2^(exp * log2(base)) with
+ *   polynomial log2 and exp2. Results under 2^-1022 flush to zero. A base that is not positive
+ *   falls back to std::pow.
+ *
+ * With specular exponents up to 1000 that keeps every term well under a hundredth of an 8 bit
+ * step, so pixels move by one step at most, where a channel sits right on a rounding edge.
+ * The approximations are written for double and only serve the double precision path.
+ */
+struct FastMath {
+  static double length(const Vec3d& vec) {
+    const double length_sq = dot(vec, vec);
+    return length_sq * detail::fast_rsqrt(length_sq);
+  }
+
+  static Vec3d normalize(const Vec3d& vec) { return detail::fast_rsqrt(dot(vec, vec)) * vec; }
+
+  static double pow(double base, double exp) {
+    if (!(base > 0.0)) { return std::pow(base, exp); }
+    return detail::fast_exp2(exp * detail::fast_log2(base));
+  }
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_PRECISION_HPP
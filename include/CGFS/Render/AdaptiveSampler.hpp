@@ -0,0 +1,282 @@
+/**
+ * @brief Adaptive supersampling: extra stratified samples only where the image has edges
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_ADAPTIVE_SAMPLER_HPP
+#define CGFS_ADAPTIVE_SAMPLER_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Canvas.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Render/FrameRenderer.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+#include "CGFS/Tracing/RayGeneration.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+#include "CGFS/Viewport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace cgfs {
+
+enum class EdgeDetection { contrast, object_id, contrast_or_object_id };
+
+/**
+ * @brief Controls for adaptive supersampling
+ *
+ * Every pixel gets min_samples samples. A pixel whose first samples differ from a 4-neighbour's
+ * by more than contrast_threshold (a fraction of full scale in any channel), or whose first
+ * sample hit a different object, is topped up to max_samples.
+ */
+using AdaptiveSamplingSettings =
+    mguid::NamedTuple<mguid::NamedType<"min_samples", int>,
+                      mguid::NamedType<"max_samples", int>,
+                      mguid::NamedType<"contrast_threshold", double>,
+                      mguid::NamedType<"edge_detection", EdgeDetection>>;
+
+constexpr AdaptiveSamplingSettings default_adaptive_sampling{
+    1, 16, 0.1, EdgeDetection::contrast_or_object_id};
+
+constexpr int max_adaptive_samples = 256;
+
+/**
+ * @brief The color a sample sees and the object it hit first, nullptr for the background
+ *
+ * The object is only compared for identity, so any pointer that names it works.
+ */
+using PixelSample = mguid::NamedTuple<mguid::NamedType<"radiance", RGB64F>,
+                                      mguid::NamedType<"object", const void*>>;
+
+namespace detail {
+
+/**
+ * @brief splitmix64 finalizer, a cheap stateless hash for per-pixel jitter
+ */
+constexpr uint64_t mix_bits(uint64_t value) {
+  value += 0x9e3779b97f4a7c15ULL;
+  value = (value ^ (value >> 30U)) * 0xbf58476d1ce4e5b9ULL;
+  value = (value ^ (value >> 27U)) * 0x94d049bb133111ebULL;
+  return value ^ (value >> 31U);
+}
+
+constexpr double unit_random(uint64_t seed) {
+  return static_cast<double>(mix_bits(seed) >> 11U) * 0x1.0p-53;
+}
+
+/**
+ * @brief Offsets in [-0.5, 0.5)^2 for count stratified samples of pixel (x, y)
+ *
+ * Samples are placed N-rooks style: sample i is jittered inside column i and inside a shuffled
+ * row, so any count stratifies both axes. The pattern depends only on the pixel and salt, which
+ * keeps renders deterministic regardless of scheduling.
+ */
+inline void stratified_offsets(int32_t x, int32_t y, uint64_t salt, std::span<Vec2d> offsets) {
+  const auto count = offsets.size();
+  const uint64_t pixel_seed =
+      mix_bits((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32U) ^
+               static_cast<uint64_t>(static_cast<uint32_t>(y)) ^ (salt << 56U));
+
+  std::array<uint32_t, max_adaptive_samples> rows;
+  for (uint32_t i{0}; i < count; ++i) { rows[i] = i; }
+  for (size_t i{count}; i > 1; --i) {
+    const auto j = static_cast<size_t>(mix_bits(pixel_seed + i) % i);
+    std::swap(rows[i - 1], rows[j]);
+  }
+
+  const auto strata = static_cast<double>(count);
+  for (size_t i{0}; i < count; ++i) {
+    const double jitter_x = unit_random(pixel_seed ^ (2 * i + 1));
+    const double jitter_y = unit_random(pixel_seed ^ (2 * i + 2));
+    offsets[i] = Vec2d{(static_cast<double>(i) + jitter_x) / strata - 0.5,
+                       (static_cast<double>(rows[i]) + jitter_y) / strata - 0.5};
+  }
+}
+
+inline void add_radiance(RGB64F& sum, const RGB64F& value) {
+  sum.get<"r">() += value.get<"r">();
+  sum.get<"g">() += value.get<"g">();
+  sum.get<"b">() += value.get<"b">();
+}
+
+inline RGB64F scale_radiance(const RGB64F& value, double factor) {
+  return RGB64F{value.get<"r">() * factor, value.get<"g">() * factor, value.get<"b">() * factor};
+}
+
+inline bool exceeds_contrast(const RGB64F& lhs, const RGB64F& rhs, double threshold) {
+  const auto channel = [](double value) { return std::clamp(value, 0.0, 255.0); };
+  const double limit = threshold * 255.0;
+  return std::abs(channel(lhs.get<"r">()) - channel(rhs.get<"r">())) > limit ||
+         std::abs(channel(lhs.get<"g">()) - channel(rhs.get<"g">())) > limit ||
+         std::abs(channel(lhs.get<"b">()) - channel(rhs.get<"b">())) > limit;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Shade a canvas with adaptive supersampling
+ *
+ * The first pass shades min_samples per pixel into a frame buffer. With a single sample it sits
+ * exactly on the pixel position, so flat regions come out identical to a one ray per pixel
+ * render. The second pass compares every pixel with its 4-neighbours and casts the remaining
+ * max_samples - min_samples stratified samples only for pixels on an edge, then writes the
+ * average of all samples.
+ *
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write, must provide put_pixel(x, y, Color3) and a BBoxi32
+ * @param sample_pixel callable returning the PixelSample seen at canvas position (x, y), doubles
+ * @param settings sample counts and edge detection
+ * @param tile_size edge length of a tile in pixels
+ * @return number of samples cast, for comparing against max_samples per pixel
+ */
+template <typename CanvasType, typename SamplePixel>
+size_t render_adaptive(ThreadPool& pool, CanvasType& canvas, SamplePixel&& sample_pixel,
+                       const AdaptiveSamplingSettings& settings = default_adaptive_sampling,
+                       int32_t tile_size = default_tile_size) {
+  const int min_samples = settings.get<"min_samples">();
+  const int max_samples = settings.get<"max_samples">();
+  if (min_samples < 1 || max_samples < min_samples || max_samples > max_adaptive_samples) {
+    throw std::invalid_argument("Adaptive sampling needs 1 <= min_samples <= max_samples <= 256.");
+  }
+
+  const BBoxi32 bounds = canvas_bounds(canvas);
+  const auto left = bounds.get<"left">();
+  const auto bottom = bounds.get<"bottom">();
+  const auto width = bounds.get<"right">() - left;
+  const auto height = bounds.get<"top">() - bottom;
+  if (width <= 0 || height <= 0) { return 0; }
+
+  const auto index_of = [&](int32_t x, int32_t y) {
+    return static_cast<size_t>((y - bottom) * width + (x - left));
+  };
+
+  const std::vector<BBoxi32> tiles = split_into_tiles(bounds, tile_size);
+  std::vector<RGB64F> base(static_cast<size_t>(width * height), RGB64F{0.0, 0.0, 0.0});
+  std::vector<const void*> objects(base.size(), nullptr);
+  std::atomic<size_t> sample_count{0};
+
+  // Accumulate count stratified samples of pixel (x, y) into sum, returning the first object
+  const auto supersample = [&](int32_t x, int32_t y, int count, uint64_t salt, RGB64F& sum) {
+    std::array<Vec2d, max_adaptive_samples> offsets;
+    const std::span<Vec2d> used{offsets.data(), static_cast<size_t>(count)};
+    detail::stratified_offsets(x, y, salt, used);
+
+    const void* first_object = nullptr;
+    for (size_t i{0}; i < used.size(); ++i) {
+      const PixelSample sample = sample_pixel(static_cast<double>(x) + used[i].get<"x">(),
+                                              static_cast<double>(y) + used[i].get<"y">());
+      detail::add_radiance(sum, sample.get<"radiance">());
+      if (i == 0) { first_object = sample.get<"object">(); }
+    }
+    return first_object;
+  };
+
+  pool.parallel_for(tiles.size(), [&](size_t tile_index) {
+    const BBoxi32& tile = tiles[tile_index];
+    for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+      for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+        const auto index = index_of(x, y);
+        if (min_samples == 1) {
+          const PixelSample sample = sample_pixel(static_cast<double>(x), static_cast<double>(y));
+          base[index] = sample.get<"radiance">();
+          objects[index] = sample.get<"object">();
+        } else {
+          RGB64F sum{0.0, 0.0, 0.0};
+          objects[index] = supersample(x, y, min_samples, 0, sum);
+          base[index] = detail::scale_radiance(sum, 1.0 / min_samples);
+        }
+      }
+    }
+    sample_count.fetch_add(static_cast<size_t>(tile.get<"right">() - tile.get<"left">()) *
+                           static_cast<size_t>(tile.get<"top">() - tile.get<"bottom">()) *
+                           static_cast<size_t>(min_samples));
+  });
+
+  const auto detection = settings.get<"edge_detection">();
+  const double threshold = settings.get<"contrast_threshold">();
+  const auto differs = [&](size_t lhs, size_t rhs) {
+    const bool by_object = detection != EdgeDetection::contrast && objects[lhs] != objects[rhs];
+    const bool by_contrast = detection != EdgeDetection::object_id &&
+                             detail::exceeds_contrast(base[lhs], base[rhs], threshold);
+    return by_object || by_contrast;
+  };
+
+  pool.parallel_for(tiles.size(), [&](size_t tile_index) {
+    const BBoxi32& tile = tiles[tile_index];
+    size_t extra_samples = 0;
+
+    for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+      for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+        const auto index = index_of(x, y);
+
+        const bool edge = max_samples > min_samples &&
+                          ((x > left && differs(index, index_of(x - 1, y))) ||
+                           (x + 1 < left + width && differs(index, index_of(x + 1, y))) ||
+                           (y > bottom && differs(index, index_of(x, y - 1))) ||
+                           (y + 1 < bottom + height && differs(index, index_of(x, y + 1))));
+
+        if (!edge) {
+          canvas.put_pixel(x, y, to_color3(base[index]));
+          continue;
+        }
+
+        RGB64F sum = detail::scale_radiance(base[index], static_cast<double>(min_samples));
+        supersample(x, y, max_samples - min_samples, 1, sum);
+        extra_samples += static_cast<size_t>(max_samples - min_samples);
+        canvas.put_pixel(x, y, to_color3(detail::scale_radiance(sum, 1.0 / max_samples)));
+      }
+    }
+
+    sample_count.fetch_add(extra_samples);
+  });
+
+  return sample_count.load();
+}
+
+/**
+ * @brief Ray trace a scene with adaptive supersampling
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write
+ * @param viewport viewport the canvas maps onto
+ * @param camera camera to trace from
+ * @param scene scene to trace
+ * @param settings reflection depth and contribution cutoff
+ * @param sampling sample counts and edge detection
+ * @param tile_size edge length of a tile in pixels
+ * @return number of primary rays cast
+ */
+template <size_t Height, size_t Width, typename SceneType>
+size_t render_scene_adaptive(ThreadPool& pool, StaticCanvas<Height, Width>& canvas,
+                             const Viewport& viewport, const Camera& camera,
+                             const SceneType& scene, const TraceSettings& settings,
+                             const AdaptiveSamplingSettings& sampling = default_adaptive_sampling,
+                             int32_t tile_size = default_tile_size) {
+  const CameraRayGenerator camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.get<"origin">();
+
+  return render_adaptive(
+      pool, canvas,
+      [&](double x, double y) {
+        const auto direction = camera_rays.direction(x, y);
+        const auto hit =
+            closest_intersection(cam_origin, direction, 1.0, basically_infinity, scene);
+        return PixelSample{trace_radiance(cam_origin, direction, hit, settings, scene),
+                           hit_object(hit)};
+      },
+      sampling, tile_size);
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_ADAPTIVE_SAMPLER_HPP
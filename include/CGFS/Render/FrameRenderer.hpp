@@ -0,0 +1,401 @@
+/**
+ * @brief Tile-based parallel frame rendering
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_FRAME_RENDERER_HPP
+#define CGFS_FRAME_RENDERER_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Canvas.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Precision.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+#include "CGFS/Tracing/RayGeneration.hpp"
+#include "CGFS/Tracing/RayPacket.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+#include "CGFS/Tracing/Wavefront.hpp"
+#include "CGFS/Viewport.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace cgfs {
+
+constexpr int32_t default_tile_size = 32;
+
+/**
+ * @brief Block edge lengths of the default progressive passes, coarsest first
+ *
+ * The first pass traces one pixel in 16 and is on screen after a sixteenth of the work.
+ */
+constexpr std::array<int32_t, 3> default_progressive_passes{4, 2, 1};
+
+/**
+ * @brief Split a canvas bounding box into tiles of at most tile_size x tile_size pixels
+ *
+ * Bounds are half open like the canvas loops: [left, right) x [bottom, top).
+ *
+ * @param bounds region to split
+ * @param tile_size edge length of a tile in pixels
+ * @return tiles in row-major order, covering bounds exactly once
+ */
+inline std::vector<BBoxi32> split_into_tiles(const BBoxi32& bounds,
+                                             int32_t tile_size = default_tile_size) {
+  tile_size = std::max(tile_size, 1);
+
+  const auto left = bounds.get<"left">();
+  const auto right = bounds.get<"right">();
+  const auto bottom = bounds.get<"bottom">();
+  const auto top = bounds.get<"top">();
+
+  std::vector<BBoxi32> tiles;
+  if (left >= right || bottom >= top) { return tiles; }
+
+  tiles.reserve(static_cast<size_t>(((right - left + tile_size - 1) / tile_size) *
+                                    ((top - bottom + tile_size - 1) / tile_size)));
+
+  for (auto y{bottom}; y < top; y += tile_size) {
+    for (auto x{left}; x < right; x += tile_size) {
+      tiles.emplace_back(x, std::min(x + tile_size, right), y, std::min(y + tile_size, top));
+    }
+  }
+
+  return tiles;
+}
+
+template <typename CanvasType>
+constexpr BBoxi32 canvas_bounds(const CanvasType& canvas) {
+  return BBoxi32{canvas.template get<"left">(), canvas.template get<"right">(),
+                 canvas.template get<"bottom">(), canvas.template get<"top">()};
+}
+
+/**
+ * @brief Shade every pixel of a canvas in parallel, one tile per task
+ *
+ * Every pixel belongs to exactly one tile, so concurrent put_pixel calls never touch the same
+ * bytes of the canvas buffer. The call returns only after all tiles are written, so it is safe
+ * to present the canvas afterwards.
+ *
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write, must provide put_pixel(x, y, Color3) and a BBoxi32
+ * @param shade_pixel callable returning the Color3 of canvas pixel (x, y)
+ * @param tile_size edge length of a tile in pixels
+ */
+template <typename CanvasType, typename ShadePixel>
+void render_frame(ThreadPool& pool, CanvasType& canvas, ShadePixel&& shade_pixel,
+                  int32_t tile_size = default_tile_size) {
+  const std::vector<BBoxi32> tiles = split_into_tiles(canvas_bounds(canvas), tile_size);
+
+  pool.parallel_for(tiles.size(), [&](size_t index) {
+    const BBoxi32& tile = tiles[index];
+    for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+      for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+        canvas.put_pixel(x, y, shade_pixel(x, y));
+      }
+    }
+  });
+}
+
+/**
+ * @brief Shade a canvas coarse to fine, presenting each pass as soon as it is written
+ *
+ * A pass with block size n traces the bottom-left pixel of every n x n block of a tile and
+ * fills the block with its color. Each block size must divide the one before it, so a block
+ * whose corner pixel an earlier pass already traced holds that pixel's color and is skipped.
+ * The passes together therefore shade every pixel exactly once, the same work as render_frame.
+ *
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write, must provide put_pixel(x, y, Color3) and a BBoxi32
+ * @param shade_pixel callable returning the Color3 of canvas pixel (x, y)
+ * @param present callable run on the calling thread after every pass
+ * @param block_sizes block edge lengths, coarsest first, ending in 1 for a full resolution image
+ * @param tile_size edge length of a tile in pixels
+ */
+template <typename CanvasType, typename ShadePixel, typename PresentPass>
+void render_progressive(ThreadPool& pool, CanvasType& canvas, ShadePixel&& shade_pixel,
+                        PresentPass&& present,
+                        std::span<const int32_t> block_sizes = default_progressive_passes,
+                        int32_t tile_size = default_tile_size) {
+  for (size_t pass{0}; pass < block_sizes.size(); ++pass) {
+    if (block_sizes[pass] < 1 || (pass > 0 && block_sizes[pass - 1] % block_sizes[pass] != 0)) {
+      throw std::invalid_argument("Each progressive block size must divide the previous one.");
+    }
+  }
+
+  const std::vector<BBoxi32> tiles = split_into_tiles(canvas_bounds(canvas), tile_size);
+
+  for (size_t pass{0}; pass < block_sizes.size(); ++pass) {
+    const int32_t block_size = block_sizes[pass];
+    const int32_t previous_block_size = pass == 0 ? 0 : block_sizes[pass - 1];
+
+    pool.parallel_for(tiles.size(), [&](size_t index) {
+      const BBoxi32& tile = tiles[index];
+      for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); y += block_size) {
+        for (auto x{tile.get<"left">()}; x < tile.get<"right">(); x += block_size) {
+          if (previous_block_size != 0 && (x - tile.get<"left">()) % previous_block_size == 0 &&
+              (y - tile.get<"bottom">()) % previous_block_size == 0) {
+            continue;
+          }
+
+          const Color3 color = shade_pixel(x, y);
+          const auto block_right = std::min(x + block_size, tile.get<"right">());
+          const auto block_top = std::min(y + block_size, tile.get<"top">());
+          for (auto fill_y{y}; fill_y < block_top; ++fill_y) {
+            for (auto fill_x{x}; fill_x < block_right; ++fill_x) {
+              canvas.put_pixel(fill_x, fill_y, color);
+            }
+          }
+        }
+      }
+    });
+
+    present();
+  }
+}
+
+/**
+ * @brief Ray trace a scene into a canvas using the pool
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write
+ * @param viewport viewport the canvas maps onto
+ * @param camera camera to trace from, in the scene's scalar type; see camera_cast
+ * @param scene scene to trace, a CompiledSceneF to render in single precision
+ * @param settings reflection depth and contribution cutoff for the iterative tracer
+ * @param tile_size edge length of a tile in pixels
+ */
+template <typename Precision = ExactMath, size_t Height, size_t Width, typename SceneType>
+void render_scene(ThreadPool& pool, StaticCanvas<Height, Width>& canvas, const Viewport& viewport,
+                  const BasicCamera<scene_scalar_t<SceneType>>& camera, const SceneType& scene,
+                  const TraceSettings& settings, int32_t tile_size = default_tile_size) {
+  using Scalar = scene_scalar_t<SceneType>;
+  const BasicCameraRayGenerator<Scalar> camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.template get<"origin">();
+
+  render_frame(
+      pool, canvas,
+      [&](int32_t x, int32_t y) {
+        const auto direction = camera_rays.direction(x, y);
+        return trace_ray_iterative<Precision>(cam_origin, direction, static_cast<Scalar>(1.0),
+                                              static_cast<Scalar>(basically_infinity), settings,
+                                              scene);
+      },
+      tile_size);
+}
+
+/**
+ * @brief Difference between two renders of the same frame, in 8 bit steps per channel
+ */
+using PixelError =
+    mguid::NamedTuple<mguid::NamedType<"max", int>, mguid::NamedType<"mean", double>>;
+
+/**
+ * @brief Render with a precision policy and measure the image against the exact policy
+ *
+ * Traces every pixel twice, once per policy, so it costs more than both renders together; it
+ * is meant for checking a policy on a scene, not for display. The canvas receives the image
+ * of the approximate policy.
+ *
+ * @tparam Precision policy under test
+ * @param canvas canvas to write, must provide put_pixel(x, y, Color3), its dimensions and a
+ * BBoxi32
+ * @return largest and mean absolute channel difference over the frame
+ */
+template <typename Precision, typename CanvasType, typename SceneType>
+PixelError compare_precision(ThreadPool& pool, CanvasType& canvas, const Viewport& viewport,
+                             const Camera& camera, const SceneType& scene,
+                             const TraceSettings& settings, int32_t tile_size = default_tile_size) {
+  const CameraRayGenerator camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.get<"origin">();
+  const BBoxi32 bounds = canvas_bounds(canvas);
+  const auto width = bounds.get<"right">() - bounds.get<"left">();
+  const auto height = bounds.get<"top">() - bounds.get<"bottom">();
+  if (width <= 0 || height <= 0) { return PixelError{0, 0.0}; }
+
+  // Each pixel writes only its own entry, so tiles never share one
+  std::vector<std::array<int, 3>> errors(static_cast<size_t>(width * height));
+  render_frame(
+      pool, canvas,
+      [&](int32_t x, int32_t y) {
+        const auto direction = camera_rays.direction(x, y);
+        const Color3 exact = trace_ray_iterative<ExactMath>(cam_origin, direction, 1.0,
+                                                            basically_infinity, settings, scene);
+        const Color3 approximate = trace_ray_iterative<Precision>(
+            cam_origin, direction, 1.0, basically_infinity, settings, scene);
+
+        errors[static_cast<size_t>((y - bounds.get<"bottom">()) * width +
+                                   (x - bounds.get<"left">()))] = {
+            std::abs(exact.get<"r">() - approximate.get<"r">()),
+            std::abs(exact.get<"g">() - approximate.get<"g">()),
+            std::abs(exact.get<"b">() - approximate.get<"b">())};
+        return approximate;
+      },
+      tile_size);
+
+  PixelError result{0, 0.0};
+  double total = 0.0;
+  for (const auto& pixel : errors) {
+    for (const auto error : pixel) {
+      result.get<"max">() = std::max(result.get<"max">(), error);
+      total += static_cast<double>(error);
+    }
+  }
+  result.get<"mean">() = total / (3.0 * static_cast<double>(errors.size()));
+  return result;
+}
+
+/**
+ * @brief Ray trace a scene into a canvas, casting primary rays as square packets
+ *
+ * Each tile is walked in PacketSize x PacketSize blocks. Pixels of a block that fall outside
+ * the tile are masked off, so any tile size works, although multiples of PacketSize keep every
+ * lane busy.
+ *
+ * @tparam PacketSize edge length of a packet in pixels, 2 or 4
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write
+ * @param viewport viewport the canvas maps onto
+ * @param camera camera to trace from
+ * @param scene scene to trace
+ * @param settings reflection depth and contribution cutoff for the iterative tracer
+ * @param tile_size edge length of a tile in pixels
+ */
+template <int32_t PacketSize, size_t Height, size_t Width, typename SceneType>
+void render_scene_packets(ThreadPool& pool, StaticCanvas<Height, Width>& canvas,
+                          const Viewport& viewport, const Camera& camera, const SceneType& scene,
+                          const TraceSettings& settings, int32_t tile_size = default_tile_size) {
+  static_assert(PacketSize == 2 || PacketSize == 4, "Packets are 2x2 or 4x4 pixels.");
+  constexpr auto lanes = static_cast<size_t>(PacketSize * PacketSize);
+
+  const CameraRayGenerator camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.get<"origin">();
+
+  const std::vector<BBoxi32> tiles = split_into_tiles(canvas_bounds(canvas), tile_size);
+
+  pool.parallel_for(tiles.size(), [&](size_t index) {
+    const BBoxi32& tile = tiles[index];
+    for (auto block_y{tile.get<"bottom">()}; block_y < tile.get<"top">(); block_y += PacketSize) {
+      for (auto block_x{tile.get<"left">()}; block_x < tile.get<"right">();
+           block_x += PacketSize) {
+        RayPacket<lanes> packet;
+        packet.origin = cam_origin;
+
+        // Each packet row is a run of one canvas row, clipped to the tile
+        const auto row_length =
+            static_cast<size_t>(std::min(PacketSize, tile.get<"right">() - block_x));
+        for (int32_t j{0}; j < PacketSize && block_y + j < tile.get<"top">(); ++j) {
+          const auto row = static_cast<size_t>(j * PacketSize);
+          camera_rays.fill_row(block_x, block_y + j,
+                               std::span{packet.direction_x}.subspan(row, row_length),
+                               std::span{packet.direction_y}.subspan(row, row_length),
+                               std::span{packet.direction_z}.subspan(row, row_length));
+          std::fill_n(packet.active.begin() + j * PacketSize, row_length, true);
+        }
+
+        const auto colors = trace_packet(packet, 1.0, basically_infinity, settings, scene);
+
+        for (int32_t j{0}; j < PacketSize; ++j) {
+          for (int32_t i{0}; i < PacketSize; ++i) {
+            const auto lane = static_cast<size_t>(j * PacketSize + i);
+            if (packet.active[lane]) { canvas.put_pixel(block_x + i, block_y + j, colors[lane]); }
+          }
+        }
+      }
+    }
+  });
+}
+
+/**
+ * @brief Ray trace a scene into a canvas in wavefront mode, one ray queue per tile
+ *
+ * All primary rays of a tile are generated up front and traced with trace_wavefront, so each
+ * stage runs over the whole tile before the next begins. A larger tile_size gives longer
+ * queues at the cost of fewer parallel tasks.
+ *
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write
+ * @param viewport viewport the canvas maps onto
+ * @param camera camera to trace from
+ * @param scene scene to trace
+ * @param settings reflection depth and contribution cutoff
+ * @param sort_queues whether to sort the shadow and reflection queues between stages
+ * @param tile_size edge length of a tile in pixels
+ */
+template <size_t Height, size_t Width, typename SceneType>
+void render_scene_wavefront(ThreadPool& pool, StaticCanvas<Height, Width>& canvas,
+                            const Viewport& viewport, const Camera& camera, const SceneType& scene,
+                            const TraceSettings& settings, bool sort_queues = true,
+                            int32_t tile_size = default_tile_size) {
+  const CameraRayGenerator camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.get<"origin">();
+
+  const std::vector<BBoxi32> tiles = split_into_tiles(canvas_bounds(canvas), tile_size);
+
+  pool.parallel_for(tiles.size(), [&](size_t index) {
+    const BBoxi32& tile = tiles[index];
+    const auto tile_width = tile.get<"right">() - tile.get<"left">();
+    const auto tile_height = tile.get<"top">() - tile.get<"bottom">();
+
+    std::vector<WavefrontRay> rays;
+    rays.reserve(static_cast<size_t>(tile_width * tile_height));
+    for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+      for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+        const auto direction = camera_rays.direction(x, y);
+        rays.emplace_back(cam_origin, direction, 1.0, static_cast<uint32_t>(rays.size()),
+                          settings.get<"max_depth">(), 1.0);
+      }
+    }
+
+    std::vector<RGB64F> radiance(rays.size(), RGB64F{0.0, 0.0, 0.0});
+    trace_wavefront(rays, settings, scene, sort_queues, radiance);
+
+    size_t path = 0;
+    for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+      for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+        canvas.put_pixel(x, y, to_color3(radiance[path++]));
+      }
+    }
+  });
+}
+
+/**
+ * @brief Ray trace a scene progressively, presenting every pass through Renderer::render()
+ * @param pool pool to run tiles on
+ * @param canvas canvas to write and present
+ * @param viewport viewport the canvas maps onto
+ * @param camera camera to trace from
+ * @param scene scene to trace
+ * @param settings reflection depth and contribution cutoff
+ * @param block_sizes block edge lengths, coarsest first
+ * @param tile_size edge length of a tile in pixels
+ */
+template <size_t Height, size_t Width, typename SceneType>
+void render_scene_progressive(ThreadPool& pool, StaticCanvas<Height, Width>& canvas,
+                              const Viewport& viewport, const Camera& camera,
+                              const SceneType& scene, const TraceSettings& settings,
+                              std::span<const int32_t> block_sizes = default_progressive_passes,
+                              int32_t tile_size = default_tile_size) {
+  const CameraRayGenerator camera_rays{viewport, canvas, camera};
+  const auto cam_origin = camera.get<"origin">();
+
+  render_progressive(
+      pool, canvas,
+      [&](int32_t x, int32_t y) {
+        const auto direction = camera_rays.direction(x, y);
+        return trace_ray_iterative(cam_origin, direction, 1.0, basically_infinity, settings,
+                                   scene);
+      },
+      [&]() { canvas.render(); }, block_sizes, tile_size);
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_FRAME_RENDERER_HPP
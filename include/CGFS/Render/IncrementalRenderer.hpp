@@ -0,0 +1,326 @@
+/**
+ * @brief Re-render only the tiles an object edit can affect
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_INCREMENTAL_RENDERER_HPP
+#define CGFS_INCREMENTAL_RENDERER_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+#include "CGFS/Render/FrameRenderer.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+#include "CGFS/Tracing/RayGeneration.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+#include "CGFS/Viewport.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <numeric>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief What the last render of a tile depended on
+ *
+ * path_bounds holds every surface point the tile's paths reached, primary hits and bounces, so
+ * it also contains every reflected ray that ended on a surface. Reflected rays that left the
+ * scene start inside path_bounds, and escape_directions bounds their unit directions.
+ */
+using TileRecord = mguid::NamedTuple<mguid::NamedType<"path_bounds", AABB>,
+                                     mguid::NamedType<"escape_directions", AABB>>;
+
+namespace detail {
+
+inline bool is_empty(const AABB& box) {
+  return !(box.get<"min">().get<"x">() <= box.get<"max">().get<"x">());
+}
+
+inline double bounding_radius(const AABB& box) {
+  return 0.5 * length(box.get<"max">() - box.get<"min">());
+}
+
+inline bool boxes_overlap(const AABB& lhs, const AABB& rhs) {
+  return lhs.get<"min">().get<"x">() <= rhs.get<"max">().get<"x">() &&
+         rhs.get<"min">().get<"x">() <= lhs.get<"max">().get<"x">() &&
+         lhs.get<"min">().get<"y">() <= rhs.get<"max">().get<"y">() &&
+         rhs.get<"min">().get<"y">() <= lhs.get<"max">().get<"y">() &&
+         lhs.get<"min">().get<"z">() <= rhs.get<"max">().get<"z">() &&
+         rhs.get<"min">().get<"z">() <= lhs.get<"max">().get<"z">();
+}
+
+/**
+ * @brief Conservative test for whether a sphere can block light to any point of a box
+ *
+ * The box is widened to its bounding sphere. For a point light the shadow is the cone from the
+ * light around the sphere, starting at the sphere; for a directional light it is the cylinder
+ * behind the sphere. Ambient light casts no shadow.
+ */
+inline bool may_shadow(const AABB& receivers, const Sphere& sphere, const Light& light) {
+  const auto box_center = centroid(receivers);
+  const double box_radius = bounding_radius(receivers);
+  const auto& center = sphere.get<"center">();
+  const double radius = sphere.get<"radius">();
+
+  return light.visit(
+      [](const AmbientLightProperties&) { return false; },
+      [&](const PointLightProperties& point_light) {
+        const auto to_sphere = center - point_light.get<"position">();
+        const auto to_box = box_center - point_light.get<"position">();
+        const double sphere_distance = length(to_sphere);
+        const double box_distance = length(to_box);
+
+        if (sphere_distance <= radius || box_distance <= box_radius) { return true; }
+        // Everything in the box is closer to the light than the sphere is
+        if (box_distance + box_radius < sphere_distance - radius) { return false; }
+
+        const double cos_between =
+            std::clamp(dot(to_sphere, to_box) / (sphere_distance * box_distance), -1.0, 1.0);
+        return std::acos(cos_between) <=
+               std::asin(radius / sphere_distance) + std::asin(box_radius / box_distance);
+      },
+      [&](const DirectionalLightProperties& directional_light) {
+        const auto& direction = directional_light.get<"direction">();
+        const auto towards_light = direction / length(direction);
+        const auto offset = box_center - center;
+
+        // Blockers lie towards the light from the receiver, so the box must be behind the sphere
+        const double along = dot(offset, towards_light);
+        if (along > radius + box_radius) { return false; }
+
+        return length(offset - along * towards_light) <= radius + box_radius;
+      });
+}
+
+/**
+ * @brief Conservative test for whether rays leaving a box can hit a sphere
+ *
+ * The unit directions are bounded by a cone around the center of their box. Every direction in
+ * the box lies within the widest angle of its corners, as long as that angle stays below 90
+ * degrees; wider sets are treated as reaching everything.
+ */
+inline bool may_reach(const AABB& origins, const AABB& directions, const Sphere& sphere) {
+  if (is_empty(directions)) { return false; }
+
+  const auto axis_sum = centroid(directions);
+  const double axis_length = length(axis_sum);
+  if (axis_length == 0.0) { return true; }
+  const auto axis = axis_sum / axis_length;
+
+  double max_angle = 0.0;
+  const auto& min = directions.get<"min">();
+  const auto& max = directions.get<"max">();
+  for (int corner{0}; corner < 8; ++corner) {
+    const Vec3d direction{(corner & 1) != 0 ? max.get<"x">() : min.get<"x">(),
+                          (corner & 2) != 0 ? max.get<"y">() : min.get<"y">(),
+                          (corner & 4) != 0 ? max.get<"z">() : min.get<"z">()};
+    const double direction_length = length(direction);
+    if (direction_length == 0.0) { return true; }
+    max_angle = std::max(
+        max_angle, std::acos(std::clamp(dot(direction, axis) / direction_length, -1.0, 1.0)));
+  }
+  if (max_angle >= std::numbers::pi / 2.0) { return true; }
+
+  const auto to_sphere = sphere.get<"center">() - centroid(origins);
+  const double distance = length(to_sphere);
+  const double reach = sphere.get<"radius">() + bounding_radius(origins);
+  if (distance <= reach) { return true; }
+
+  const double angle = std::acos(std::clamp(dot(to_sphere, axis) / distance, -1.0, 1.0));
+  return angle <= max_angle + std::asin(reach / distance);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Keeps a rendered frame and re-traces only the tiles an object edit can change
+ *
+ * A full render records a TileRecord per tile. When a sphere moves, a tile is re-traced if
+ * - its pixels overlap the screen-space bounds of the old or new sphere,
+ * - one of its reflected rays could reach either sphere, or
+ * - a point its paths reached can lie in either sphere's shadow from any light.
+ * Every other tile keeps its pixels from the previous frame. The tests are conservative, so the
+ * result matches a full render of the edited scene. An edit the camera sees from behind its
+ * projection plane falls back to a full re-render.
+ *
+ * @tparam CanvasType canvas with put_pixel(x, y, Color3), a BBoxi32 and width/height
+ */
+template <typename CanvasType>
+class IncrementalRenderer {
+public:
+  IncrementalRenderer(ThreadPool& pool, CanvasType& canvas, const Viewport& viewport,
+                      const Camera& camera, const TraceSettings& settings,
+                      int32_t tile_size = default_tile_size)
+      : m_pool{pool},
+        m_canvas{canvas},
+        m_viewport{viewport},
+        m_camera{camera},
+        m_settings{settings},
+        m_tiles{split_into_tiles(canvas_bounds(canvas), tile_size)},
+        m_records(m_tiles.size(), TileRecord{empty_aabb(), empty_aabb()}) {}
+
+  /**
+   * @brief Render every tile and record what each depends on
+   */
+  void render(const CompiledScene& scene) {
+    std::vector<size_t> all(m_tiles.size());
+    std::iota(all.begin(), all.end(), size_t{0});
+    render_tiles(scene, all);
+  }
+
+  /**
+   * @brief Replace a sphere and re-trace the tiles the change can affect
+   * @param scene scene the frame was rendered from, edited in place
+   * @param index index of the sphere in the Scene the compiled scene was built from
+   * @param sphere new sphere
+   * @return number of tiles re-traced
+   */
+  size_t update_sphere(CompiledScene& scene, size_t index, const Sphere& sphere) {
+    const Sphere previous = cgfs::update_sphere(scene, index, sphere);
+    const auto dirty = dirty_tiles(scene.get<"lights">(), previous, sphere);
+    render_tiles(scene, dirty);
+    return dirty.size();
+  }
+
+  /**
+   * @brief Tiles whose pixels can change when old_sphere is replaced by new_sphere
+   */
+  [[nodiscard]] std::vector<size_t> dirty_tiles(std::span<const Light> lights,
+                                                const Sphere& old_sphere,
+                                                const Sphere& new_sphere) const {
+    std::vector<size_t> dirty;
+
+    const auto old_rect = screen_bounds(old_sphere);
+    const auto new_rect = screen_bounds(new_sphere);
+    const AABB old_bounds = bounds_of(old_sphere);
+    const AABB new_bounds = bounds_of(new_sphere);
+
+    for (size_t i{0}; i < m_tiles.size(); ++i) {
+      const auto& tile = m_tiles[i];
+      const auto& path_bounds = m_records[i].get<"path_bounds">();
+      const auto& escape_directions = m_records[i].get<"escape_directions">();
+      const bool has_paths = !detail::is_empty(path_bounds);
+
+      const bool seen = !old_rect || !new_rect || overlaps(tile, *old_rect) ||
+                        overlaps(tile, *new_rect);
+      const bool reflected =
+          has_paths && (detail::boxes_overlap(path_bounds, old_bounds) ||
+                        detail::boxes_overlap(path_bounds, new_bounds) ||
+                        detail::may_reach(path_bounds, escape_directions, old_sphere) ||
+                        detail::may_reach(path_bounds, escape_directions, new_sphere));
+      const bool shadowed =
+          has_paths && std::any_of(lights.begin(), lights.end(), [&](const Light& light) {
+            return detail::may_shadow(path_bounds, old_sphere, light) ||
+                   detail::may_shadow(path_bounds, new_sphere, light);
+          });
+
+      if (seen || reflected || shadowed) { dirty.push_back(i); }
+    }
+
+    return dirty;
+  }
+
+  [[nodiscard]] const std::vector<BBoxi32>& tiles() const { return m_tiles; }
+
+private:
+  struct TileRecorder {
+    AABB bounds{empty_aabb()};
+    AABB escape_directions{empty_aabb()};
+
+    void on_hit(int, const Vec3d& point) { bounds = merge(bounds, point); }
+    void on_miss(int bounce, const Origin&, const Vec3d& direction) {
+      if (bounce == 0) { return; }
+      escape_directions = merge(escape_directions, direction / length(direction));
+    }
+  };
+
+  void render_tiles(const CompiledScene& scene, std::span<const size_t> tile_indices) {
+    const CameraRayGenerator camera_rays{m_viewport, m_canvas, m_camera};
+    const auto cam_origin = m_camera.get<"origin">();
+
+    m_pool.parallel_for(tile_indices.size(), [&](size_t i) {
+      const auto tile_index = tile_indices[i];
+      const BBoxi32& tile = m_tiles[tile_index];
+      TileRecorder recorder;
+
+      for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+        for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+          const auto direction = camera_rays.direction(x, y);
+          const auto hit =
+              closest_intersection(cam_origin, direction, 1.0, basically_infinity, scene);
+          m_canvas.put_pixel(
+              x, y,
+              to_color3(trace_radiance(cam_origin, direction, hit, m_settings, scene, recorder)));
+        }
+      }
+
+      m_records[tile_index] = TileRecord{recorder.bounds, recorder.escape_directions};
+    });
+  }
+
+  /**
+   * @brief Inclusive canvas rectangle a sphere can cover, std::nullopt if it reaches behind the
+   * camera plane
+   */
+  [[nodiscard]] std::optional<BBoxi32> screen_bounds(const Sphere& sphere) const {
+    const AABB bounds = bounds_of(sphere);
+    const auto& min = bounds.get<"min">();
+    const auto& max = bounds.get<"max">();
+
+    double left = basically_infinity;
+    double right = -basically_infinity;
+    double bottom = basically_infinity;
+    double top = -basically_infinity;
+    for (int corner{0}; corner < 8; ++corner) {
+      const Vec3d point{(corner & 1) != 0 ? max.get<"x">() : min.get<"x">(),
+                        (corner & 2) != 0 ? max.get<"y">() : min.get<"y">(),
+                        (corner & 4) != 0 ? max.get<"z">() : min.get<"z">()};
+      const std::optional<Vec2d> projected =
+          world_to_canvas(point, m_viewport, m_canvas, m_camera);
+      if (!projected) { return std::nullopt; }
+
+      const Vec2d& position = *projected;
+      left = std::min(left, position.get<"x">());
+      right = std::max(right, position.get<"x">());
+      bottom = std::min(bottom, position.get<"y">());
+      top = std::max(top, position.get<"y">());
+    }
+
+    // Pad by a pixel so rounding never drops a column or row the sphere touches
+    const auto clamp_to_int = [](double value) {
+      return static_cast<int32_t>(std::clamp(value, -1.0e9, 1.0e9));
+    };
+    return BBoxi32{clamp_to_int(std::floor(left)) - 1, clamp_to_int(std::ceil(right)) + 1,
+                   clamp_to_int(std::floor(bottom)) - 1, clamp_to_int(std::ceil(top)) + 1};
+  }
+
+  static bool overlaps(const BBoxi32& tile, const BBoxi32& rect) {
+    return tile.get<"left">() <= rect.get<"right">() && rect.get<"left">() < tile.get<"right">() &&
+           tile.get<"bottom">() <= rect.get<"top">() && rect.get<"bottom">() < tile.get<"top">();
+  }
+
+  ThreadPool& m_pool;
+  CanvasType& m_canvas;
+  Viewport m_viewport;
+  Camera m_camera;
+  TraceSettings m_settings;
+  std::vector<BBoxi32> m_tiles;
+  std::vector<TileRecord> m_records;
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_INCREMENTAL_RENDERER_HPP
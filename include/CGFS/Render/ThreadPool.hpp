@@ -0,0 +1,214 @@
+/**
+ * @brief Persistent work-stealing thread pool
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_THREAD_POOL_HPP
+#define CGFS_THREAD_POOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief A fixed set of worker threads, each owning a task deque
+ *
+ * Workers pop from the back of their own deque and steal from the front of the others when
+ * they run dry, so a batch that is split unevenly still keeps every core busy. Threads are
+ * created once and reused for every frame.
+ */
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  explicit ThreadPool(std::size_t thread_count = default_thread_count()) {
+    thread_count = std::max<std::size_t>(thread_count, 1);
+
+    m_queues.reserve(thread_count);
+    for (std::size_t i{0}; i < thread_count; ++i) {
+      m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    m_workers.reserve(thread_count);
+    for (std::size_t i{0}; i < thread_count; ++i) {
+      m_workers.emplace_back([this, i]() { worker_loop(i); });
+    }
+  }
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  ~ThreadPool() {
+    {
+      std::lock_guard lock{m_wake_mutex};
+      m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& worker : m_workers) { worker.join(); }
+  }
+
+  [[nodiscard]] static std::size_t default_thread_count() {
+    return std::max<std::size_t>(std::thread::hardware_concurrency(), 1);
+  }
+
+  [[nodiscard]] std::size_t size() const { return m_workers.size(); }
+
+  /**
+   * @brief Queue a task; a task submitted from a worker goes onto that worker's own deque
+   * @param task callable to run on some worker
+   */
+  void submit(Task task) {
+    const std::size_t index = (t_owner == this) ? t_worker_index : next_queue();
+    push(index, std::move(task));
+  }
+
+  /**
+   * @brief Run func(i) for every i in [0, count) and block until all calls have returned
+   *
+   * Indices are dealt out to the worker deques in contiguous runs so neighbouring work tends
+   * to stay on one core. The calling thread helps drain the queues while it waits, which also
+   * makes nested calls from inside a task safe. The first exception thrown by any call is
+   * rethrown here once the batch has finished.
+   *
+   * @param count number of indices
+   * @param func callable invoked as func(std::size_t)
+   */
+  template <typename Func>
+  void parallel_for(std::size_t count, Func&& func) {
+    if (count == 0) { return; }
+
+    struct Batch {
+      std::atomic<std::size_t> remaining;
+      std::mutex mutex;
+      std::condition_variable done;
+      std::exception_ptr error{nullptr};
+    };
+
+    auto batch = std::make_shared<Batch>();
+    batch->remaining.store(count);
+
+    const std::size_t queue_count = m_queues.size();
+    for (std::size_t i{0}; i < count; ++i) {
+      push(i * queue_count / count, [batch, &func, i]() {
+        try {
+          func(i);
+        } catch (...) {
+          std::lock_guard lock{batch->mutex};
+          if (!batch->error) { batch->error = std::current_exception(); }
+        }
+        if (batch->remaining.fetch_sub(1) == 1) {
+          std::lock_guard lock{batch->mutex};
+          batch->done.notify_all();
+        }
+      });
+    }
+
+    const std::size_t home = (t_owner == this) ? t_worker_index : 0;
+    while (batch->remaining.load() != 0) {
+      if (Task task; try_pop(home, task) || try_steal(home, task)) {
+        task();
+        continue;
+      }
+      std::unique_lock lock{batch->mutex};
+      batch->done.wait(lock, [&batch]() { return batch->remaining.load() == 0; });
+    }
+
+    if (batch->error) { std::rethrow_exception(batch->error); }
+  }
+
+private:
+  struct WorkQueue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::size_t next_queue() { return m_next_queue.fetch_add(1) % m_queues.size(); }
+
+  void push(std::size_t index, Task task) {
+    {
+      std::lock_guard lock{m_queues[index]->mutex};
+      m_queues[index]->tasks.push_back(std::move(task));
+    }
+    {
+      std::lock_guard lock{m_wake_mutex};
+      ++m_pending;
+    }
+    m_wake.notify_one();
+  }
+
+  bool try_pop(std::size_t index, Task& task) {
+    auto& queue = *m_queues[index];
+    {
+      std::lock_guard lock{queue.mutex};
+      if (queue.tasks.empty()) { return false; }
+      task = std::move(queue.tasks.back());
+      queue.tasks.pop_back();
+    }
+    take_pending();
+    return true;
+  }
+
+  bool try_steal(std::size_t thief, Task& task) {
+    const std::size_t queue_count = m_queues.size();
+    for (std::size_t offset{1}; offset < queue_count + 1; ++offset) {
+      auto& queue = *m_queues[(thief + offset) % queue_count];
+      {
+        std::lock_guard lock{queue.mutex};
+        if (queue.tasks.empty()) { continue; }
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+      }
+      take_pending();
+      return true;
+    }
+    return false;
+  }
+
+  void take_pending() {
+    std::lock_guard lock{m_wake_mutex};
+    --m_pending;
+  }
+
+  void worker_loop(std::size_t index) {
+    t_owner = this;
+    t_worker_index = index;
+
+    while (true) {
+      if (Task task; try_pop(index, task) || try_steal(index, task)) {
+        task();
+        continue;
+      }
+
+      std::unique_lock lock{m_wake_mutex};
+      m_wake.wait(lock, [this]() { return m_stop || m_pending != 0; });
+      if (m_stop && m_pending == 0) { return; }
+    }
+  }
+
+  static inline thread_local ThreadPool* t_owner{nullptr};
+  static inline thread_local std::size_t t_worker_index{0};
+
+  std::vector<std::unique_ptr<WorkQueue>> m_queues;
+  std::vector<std::thread> m_workers;
+  std::atomic<std::size_t> m_next_queue{0};
+
+  std::mutex m_wake_mutex;
+  std::condition_variable m_wake;
+  std::size_t m_pending{0};
+  bool m_stop{false};
+};
+
+}  // namespace cgfs
+
+#endif  // CGFS_THREAD_POOL_HPP
@@ -0,0 +1,139 @@
+/**
+ * @brief Ray queries against shared geometry and its instances
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_INSTANCE_INTERSECTION_HPP
+#define CGFS_INSTANCE_INTERSECTION_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Instance.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/MeshIntersection.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace cgfs {
+
+/**
+ * @brief Closest hit on a shared geometry, in its object space
+ *
+ * Sphere hits are reported like shape hits, with their normal already worked out, because the
+ * world space hit point a caller has is not in the sphere's space.
+ */
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const InstanceGeometry& geometry) {
+  double closest_t_value = basically_infinity;
+  Sphere const* closest_sphere = nullptr;
+
+  geometry.bvh().traverse(origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+    const auto hit = intersect_spheres(geometry.sphere_soa(), origin, direction, t_min, t_max,
+                                       first, first + count);
+    if (hit.get<"index">() != no_sphere) {
+      closest_t_value = hit.get<"t">();
+      closest_sphere = &geometry.spheres()[hit.get<"index">()];
+      t_max = closest_t_value;
+    }
+    return false;
+  });
+
+  ClosestIntersectionResult closest{nullptr, basically_infinity, ShapeHit{}};
+  if (closest_sphere != nullptr) {
+    const auto normal = origin + (closest_t_value * direction) - closest_sphere->get<"center">();
+    closest = ClosestIntersectionResult{
+        nullptr, closest_t_value,
+        ShapeHit{&closest_sphere->get<"material">(), normal / closest_sphere->get<"radius">(),
+                 closest_sphere, true}};
+  }
+
+  for (const auto& mesh : geometry.meshes()) {
+    const auto hit = closest_intersection(origin, direction, t_min, t_max, mesh);
+    if (!is_hit(hit)) { continue; }
+    t_max = hit.get<"closest_t">();
+    closest = hit;
+  }
+
+  return closest;
+}
+
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const InstanceGeometry& geometry) {
+  const bool sphere_blocks = geometry.bvh().traverse(
+      origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+        return any_sphere_hit(geometry.sphere_soa(), origin, direction, t_min, t_max, first,
+                              first + count);
+      });
+
+  return sphere_blocks ||
+         std::any_of(geometry.meshes().begin(), geometry.meshes().end(),
+                     [&](const TriangleMesh& mesh) {
+                       return occluded(origin, direction, t_min, t_max, mesh);
+                     });
+}
+
+/**
+ * @brief Closest hit among a set of instances, walking the top level BVH
+ *
+ * Each instance the walk reaches gets the ray mapped into its object space. The direction is
+ * not renormalized, so distances along it match world space ones and t_max keeps pruning
+ * across instances. Only the winning normal is mapped back to world space.
+ */
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const InstanceSet& set) {
+  ClosestIntersectionResult closest{nullptr, basically_infinity, ShapeHit{}};
+  Instance const* closest_instance = nullptr;
+
+  const auto& instances = set.instances();
+  set.tlas().traverse(origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+    for (uint32_t i{first}; i < first + count; ++i) {
+      const auto& transform = instances[i].get<"transform">();
+      const auto hit = closest_intersection(to_object_point(transform, origin),
+                                            to_object_direction(transform, direction), t_min,
+                                            t_max, set.geometry_of(instances[i]));
+      if (!is_hit(hit)) { continue; }
+      closest = hit;
+      closest_instance = &instances[i];
+      t_max = hit.get<"closest_t">();
+    }
+    return false;
+  });
+
+  if (closest_instance == nullptr) { return closest; }
+
+  const auto material_index = closest_instance->get<"material">();
+  const auto& object_hit = closest.get<"closest_shape">();
+  return ClosestIntersectionResult{
+      nullptr, closest.get<"closest_t">(),
+      ShapeHit{material_index == no_material_override ? object_hit.get<"material">()
+                                                      : &set.materials()[material_index],
+               to_world_normal(closest_instance->get<"transform">(), object_hit.get<"normal">()),
+               closest_instance, true}};
+}
+
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const InstanceSet& set) {
+  const auto& instances = set.instances();
+  return set.tlas().traverse(
+      origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+        return std::any_of(instances.begin() + first, instances.begin() + first + count,
+                           [&](const Instance& instance) {
+                             const auto& transform = instance.get<"transform">();
+                             return occluded(to_object_point(transform, origin),
+                                             to_object_direction(transform, direction), t_min,
+                                             t_max, set.geometry_of(instance));
+                           });
+      });
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_INSTANCE_INTERSECTION_HPP
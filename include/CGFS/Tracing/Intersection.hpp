@@ -0,0 +1,188 @@
+/**
+ * @brief Ray-object intersection queries
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_INTERSECTION_HPP
+#define CGFS_INTERSECTION_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Material/Material.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Sphere.hpp"
+#include "CGFS/Precision.hpp"
+#include "CGFS/Scene.hpp"
+
+#include <span>
+
+namespace cgfs {
+
+using RaySphereIntersectResult =
+    mguid::NamedTuple<mguid::NamedType<"t1", double>, mguid::NamedType<"t2", double>>;
+
+constexpr RaySphereIntersectResult intersect_ray_sphere(const Origin& origin,
+                                                        const Vec3d& direction,
+                                                        const Sphere& sphere) {
+  const double r = sphere.get<"radius">();
+
+  const Vec3d c_o = origin - sphere.get<"center">();
+
+  const double a = dot(direction, direction);
+  const double b = 2.0 * dot(c_o, direction);
+  const double c = dot(c_o, c_o) - (r * r);
+
+  const double discriminant = (b * b) - (4.0 * a * c);
+  if (discriminant < 0.0) {
+    return RaySphereIntersectResult{basically_infinity, basically_infinity};
+  }
+
+  const double t1 = (-b + sqrt(discriminant)) / (2.0 * a);
+  const double t2 = (-b - sqrt(discriminant)) / (2.0 * a);
+
+  return RaySphereIntersectResult{t1, t2};
+}
+
+/**
+ * @brief Surface of a hit that was resolved by the query itself
+ *
+ * Used for every hit except one on a Sphere object, which shading resolves lazily through
+ * closest_sphere. material is null when there is no such hit. normal faces the incoming ray, or
+ * points outward on spheres. It is a unit vector when unit_normal is set; otherwise hit_normal
+ * normalizes it with the caller's precision policy, as compiled sphere hits leave it. object
+ * identifies the primitive that was hit.
+ */
+using ShapeHit = mguid::NamedTuple<mguid::NamedType<"material", MaterialProperties const*>,
+                                   mguid::NamedType<"normal", Vec3d>,
+                                   mguid::NamedType<"object", const void*>,
+                                   mguid::NamedType<"unit_normal", bool>>;
+
+using ClosestIntersectionResult =
+    mguid::NamedTuple<mguid::NamedType<"closest_sphere", Sphere const*>,
+                      mguid::NamedType<"closest_t", double>,
+                      mguid::NamedType<"closest_shape", ShapeHit>>;
+
+constexpr bool is_hit(const ClosestIntersectionResult& hit) {
+  return hit.get<"closest_sphere">() != nullptr ||
+         hit.get<"closest_shape">().get<"material">() != nullptr;
+}
+
+/**
+ * @brief Material of the surface a ray hit; the hit must not be a miss
+ */
+constexpr const MaterialProperties& hit_material(const ClosestIntersectionResult& hit) {
+  const auto* sphere = hit.get<"closest_sphere">();
+  return sphere != nullptr ? sphere->get<"material">()
+                           : *hit.get<"closest_shape">().get<"material">();
+}
+
+/**
+ * @brief Unit surface normal at the point a ray hit; the hit must not be a miss
+ */
+template <typename Precision = ExactMath>
+constexpr Vec3d hit_normal(const ClosestIntersectionResult& hit, const Vec3d& point) {
+  const auto* sphere = hit.get<"closest_sphere">();
+  if (sphere == nullptr) {
+    const auto& shape = hit.get<"closest_shape">();
+    return shape.get<"unit_normal">() ? shape.get<"normal">()
+                                      : Precision::normalize(shape.get<"normal">());
+  }
+
+  return Precision::normalize(point - sphere->get<"center">());
+}
+
+/**
+ * @brief Origin for the shadow and reflection rays leaving a hit, the hit point itself
+ *
+ * Double precision hits are close enough to their surface for the 0.001 t_min of secondary rays.
+ */
+constexpr Vec3d spawn_point(const ClosestIntersectionResult&, const Vec3d& point, const Vec3d&) {
+  return point;
+}
+
+/**
+ * @brief Identity of the object a ray hit, null for a miss
+ */
+constexpr const void* hit_object(const ClosestIntersectionResult& hit) {
+  const auto* sphere = hit.get<"closest_sphere">();
+  return sphere != nullptr ? static_cast<const void*>(sphere)
+                           : hit.get<"closest_shape">().get<"object">();
+}
+
+/**
+ * @brief Closest hit among a contiguous run of spheres
+ *
+ * The scene overloads forward here, so the loop is instantiated once no matter how many scene
+ * sizes a program uses.
+ */
+constexpr ClosestIntersectionResult closest_intersection(const Origin& origin,
+                                                         const Vec3d& direction, double t_min,
+                                                         double t_max,
+                                                         std::span<const Sphere> objects) {
+  double closest_t_value = basically_infinity;  // closest ray object intersection
+
+  Sphere const* closest_sphere = nullptr;
+
+  constexpr auto in_range = [](double val, double rng_min, double rng_max) {
+    return val > rng_min && val < rng_max;
+  };
+
+  for (const auto& sphere : objects) {
+    const auto [t1, t2] = intersect_ray_sphere(origin, direction, sphere);
+
+    if (in_range(t1, t_min, t_max) && t1 < closest_t_value) {
+      closest_t_value = t1;
+      closest_sphere = &sphere;
+    }
+    if (in_range(t2, t_min, t_max) && t2 < closest_t_value) {
+      closest_t_value = t2;
+      closest_sphere = &sphere;
+    }
+  }
+
+  return ClosestIntersectionResult{closest_sphere, closest_t_value, ShapeHit{}};
+}
+
+template <size_t NumObjects, size_t NumLights>
+constexpr ClosestIntersectionResult closest_intersection(
+    const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+    const Scene<NumObjects, NumLights>& scene) {
+  return closest_intersection(origin, direction, t_min, t_max,
+                              std::span<const Sphere>{scene.template get<"objects">()});
+}
+
+/**
+ * @brief Any-hit shadow query: whether any of the spheres blocks the ray within (t_min, t_max)
+ *
+ * Returns at the first blocker found and never computes where the hit is.
+ */
+constexpr bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                        std::span<const Sphere> objects) {
+  const double a = dot(direction, direction);
+
+  for (const auto& sphere : objects) {
+    const double r = sphere.get<"radius">();
+    const Vec3d c_o = origin - sphere.get<"center">();
+
+    if (quadratic_has_root_between(a, dot(c_o, direction), dot(c_o, c_o) - (r * r), t_min,
+                                   t_max)) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
+template <size_t NumObjects, size_t NumLights>
+constexpr bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                        const Scene<NumObjects, NumLights>& scene) {
+  return occluded(origin, direction, t_min, t_max,
+                  std::span<const Sphere>{scene.template get<"objects">()});
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_INTERSECTION_HPP
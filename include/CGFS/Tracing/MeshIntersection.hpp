@@ -0,0 +1,168 @@
+/**
+ * @brief Watertight ray-triangle kernel and mesh queries
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_MESH_INTERSECTION_HPP
+#define CGFS_MESH_INTERSECTION_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Mesh.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+namespace cgfs {
+
+/**
+ * @brief Per ray setup of the watertight triangle test
+ *
+ * The ray is turned into the +z axis of a sheared frame, which reduces every triangle test to
+ * 2D edge functions around the origin. Edges shared by two triangles then produce exactly
+ * opposite edge function values, so a ray through an edge or vertex always hits at least one of
+ * the triangles meeting there; no cracks open between them (Woop, Benthin and Wald 2013).
+ */
+struct WatertightRay {
+  explicit WatertightRay(const Origin& ray_origin, const Vec3d& direction) {
+    origin = {ray_origin.get<"x">(), ray_origin.get<"y">(), ray_origin.get<"z">()};
+    const std::array<double, 3> d{direction.get<"x">(), direction.get<"y">(),
+                                  direction.get<"z">()};
+
+    kz = std::abs(d[0]) > std::abs(d[1]) ? (std::abs(d[0]) > std::abs(d[2]) ? 0U : 2U)
+                                          : (std::abs(d[1]) > std::abs(d[2]) ? 1U : 2U);
+    kx = (kz + 1) % 3;
+    ky = (kx + 1) % 3;
+    // Keep the winding of the projected triangle independent of the direction's sign
+    if (d[kz] < 0.0) { std::swap(kx, ky); }
+
+    shear_x = d[kx] / d[kz];
+    shear_y = d[ky] / d[kz];
+    shear_z = 1.0 / d[kz];
+  }
+
+  std::array<double, 3> origin{};
+  size_t kx{0};
+  size_t ky{0};
+  size_t kz{0};
+  double shear_x{0.0};
+  double shear_y{0.0};
+  double shear_z{0.0};
+};
+
+using TriangleHit =
+    mguid::NamedTuple<mguid::NamedType<"t", double>, mguid::NamedType<"slot", uint32_t>>;
+
+constexpr uint32_t no_triangle = std::numeric_limits<uint32_t>::max();
+
+/**
+ * @brief Closest watertight hit among the mesh triangles in leaf order slots [first, last)
+ *
+ * The loop body has no early exit and reads one stream per corner and axis, so the compiler can
+ * run it several triangles at a time.
+ */
+inline TriangleHit intersect_triangles(const TriangleMesh& mesh, const WatertightRay& ray,
+                                       double t_min, double t_max, uint32_t first,
+                                       uint32_t last) {
+  const auto stream = [&](size_t corner, size_t axis) { return mesh.corner_stream(corner, axis); };
+  const double* ax = stream(0, ray.kx);
+  const double* ay = stream(0, ray.ky);
+  const double* az = stream(0, ray.kz);
+  const double* bx = stream(1, ray.kx);
+  const double* by = stream(1, ray.ky);
+  const double* bz = stream(1, ray.kz);
+  const double* cx = stream(2, ray.kx);
+  const double* cy = stream(2, ray.ky);
+  const double* cz = stream(2, ray.kz);
+
+  const double ox = ray.origin[ray.kx];
+  const double oy = ray.origin[ray.ky];
+  const double oz = ray.origin[ray.kz];
+
+  double best_t = t_max;
+  uint32_t best_slot = no_triangle;
+
+  for (uint32_t i{first}; i < last; ++i) {
+    const double a_z = az[i] - oz;
+    const double b_z = bz[i] - oz;
+    const double c_z = cz[i] - oz;
+    const double a_x = ax[i] - ox - ray.shear_x * a_z;
+    const double a_y = ay[i] - oy - ray.shear_y * a_z;
+    const double b_x = bx[i] - ox - ray.shear_x * b_z;
+    const double b_y = by[i] - oy - ray.shear_y * b_z;
+    const double c_x = cx[i] - ox - ray.shear_x * c_z;
+    const double c_y = cy[i] - oy - ray.shear_y * c_z;
+
+    const double u = c_x * b_y - c_y * b_x;
+    const double v = a_x * c_y - a_y * c_x;
+    const double w = b_x * a_y - b_y * a_x;
+
+    const bool inside = (u >= 0.0 && v >= 0.0 && w >= 0.0) || (u <= 0.0 && v <= 0.0 && w <= 0.0);
+    const double determinant = u + v + w;
+    const double t = (u * a_z + v * b_z + w * c_z) * ray.shear_z / determinant;
+
+    const bool closer = inside && determinant != 0.0 && t > t_min && t < best_t;
+    best_t = closer ? t : best_t;
+    best_slot = closer ? i : best_slot;
+  }
+
+  return TriangleHit{best_slot == no_triangle ? basically_infinity : best_t, best_slot};
+}
+
+/**
+ * @brief Closest hit on a mesh, walking its BVH
+ *
+ * The normal is the face normal, flipped to face the ray.
+ */
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const TriangleMesh& mesh) {
+  const WatertightRay ray{origin, direction};
+
+  double closest_t_value = basically_infinity;
+  uint32_t closest_slot = no_triangle;
+
+  mesh.bvh().traverse(origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+    const auto hit = intersect_triangles(mesh, ray, t_min, t_max, first, first + count);
+    if (hit.get<"slot">() != no_triangle) {
+      closest_t_value = hit.get<"t">();
+      closest_slot = hit.get<"slot">();
+      t_max = closest_t_value;
+    }
+    return false;
+  });
+
+  if (closest_slot == no_triangle) {
+    return ClosestIntersectionResult{nullptr, basically_infinity, ShapeHit{}};
+  }
+
+  const auto face = mesh.bvh().primitive_order()[closest_slot];
+  const auto& v0 = mesh.vertex(face, 0);
+  auto normal = cross(mesh.vertex(face, 1) - v0, mesh.vertex(face, 2) - v0);
+  normal = normal / length(normal);
+  if (dot(normal, direction) > 0.0) { normal = -normal; }
+
+  return ClosestIntersectionResult{nullptr, closest_t_value,
+                                   ShapeHit{&mesh.face_material(face), normal, &mesh, true}};
+}
+
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const TriangleMesh& mesh) {
+  const WatertightRay ray{origin, direction};
+
+  return mesh.bvh().traverse(origin, direction, t_min, t_max, [&](uint32_t first, uint32_t count) {
+    return intersect_triangles(mesh, ray, t_min, t_max, first, first + count).get<"slot">() !=
+           no_triangle;
+  });
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_MESH_INTERSECTION_HPP
@@ -0,0 +1,174 @@
+/**
+ * @brief Primary ray generation from canvas coordinates
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_RAY_GENERATION_HPP
+#define CGFS_RAY_GENERATION_HPP
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Canvas.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Viewport.hpp"
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+namespace cgfs {
+
+/**
+ * @brief Map a possibly fractional canvas position onto the projection plane
+ *
+ * Sub-pixel positions are how supersampling places several rays inside one pixel. The ray is in
+ * the camera's scalar type, so a CameraF generates rays for the single precision path.
+ */
+template <typename CanvasType, typename Scalar>
+constexpr Vec3<Scalar> canvas_to_viewport(const Vec2<Scalar>& point, const Viewport& viewport,
+                                          const CanvasType& canvas,
+                                          const BasicCamera<Scalar>& camera) {
+  const Scalar distance_camera_to_proj_plane =
+      camera.template get<"projection_plane">().template get<"distance">();
+
+  const auto c_w = static_cast<Scalar>(canvas.template get<"width">());
+  const auto c_h = static_cast<Scalar>(canvas.template get<"height">());
+  const auto v_w = static_cast<Scalar>(viewport.get<"width">());
+  const auto v_h = static_cast<Scalar>(viewport.get<"height">());
+
+  return Vec3<Scalar>{point.template get<"x">() * v_w / c_w,
+                      point.template get<"y">() * v_h / c_h, distance_camera_to_proj_plane};
+}
+
+template <typename CanvasType, typename Scalar>
+constexpr Vec3<Scalar> canvas_to_viewport(const Vec2i32& point, const Viewport& viewport,
+                                          const CanvasType& canvas,
+                                          const BasicCamera<Scalar>& camera) {
+  return canvas_to_viewport(Vec2<Scalar>{static_cast<Scalar>(point.get<"x">()),
+                                         static_cast<Scalar>(point.get<"y">())},
+                            viewport, canvas, camera);
+}
+
+/**
+ * @brief Primary ray directions of one frame, from deltas worked out once per frame
+ *
+ * A ray direction is linear in the canvas position, rotation * (x * v_w / c_w, y * v_h / c_h, d),
+ * so the rotated step per pixel and per row and the rotated center ray are all a frame needs.
+ * Each direction then costs a multiply-add per component instead of two divisions and a matrix
+ * product. Results match canvas_to_viewport followed by the rotation up to rounding.
+ */
+template <typename Scalar>
+class BasicCameraRayGenerator {
+public:
+  template <typename CanvasType>
+  BasicCameraRayGenerator(const Viewport& viewport, const CanvasType& canvas,
+                          const BasicCamera<Scalar>& camera) {
+    const auto& rotation = camera.template get<"rotation">();
+    const Scalar distance =
+        camera.template get<"projection_plane">().template get<"distance">();
+    const Scalar pixel_width = static_cast<Scalar>(viewport.get<"width">()) /
+                               static_cast<Scalar>(canvas.template get<"width">());
+    const Scalar pixel_height = static_cast<Scalar>(viewport.get<"height">()) /
+                                static_cast<Scalar>(canvas.template get<"height">());
+
+    for (size_t i = 0; i < 3; ++i) {
+      m_pixel_step[i] = rotation[i][0] * pixel_width;
+      m_row_step[i] = rotation[i][1] * pixel_height;
+      m_center[i] = rotation[i][2] * distance;
+    }
+  }
+
+  /**
+   * @brief Direction of the primary ray through a possibly fractional canvas position
+   */
+  [[nodiscard]] constexpr Vec3<Scalar> direction(Scalar x, Scalar y) const {
+    return Vec3<Scalar>{m_center[0] + x * m_pixel_step[0] + y * m_row_step[0],
+                        m_center[1] + x * m_pixel_step[1] + y * m_row_step[1],
+                        m_center[2] + x * m_pixel_step[2] + y * m_row_step[2]};
+  }
+
+  [[nodiscard]] constexpr Vec3<Scalar> direction(int32_t x, int32_t y) const {
+    return direction(static_cast<Scalar>(x), static_cast<Scalar>(y));
+  }
+
+  /**
+   * @brief Write the directions of a run of pixels in one row, one stream per component
+   *
+   * Fills as many pixels as the streams hold, starting at (left, y) and moving right. The row's
+   * first direction is worked out once and every later one is a multiple of the pixel step
+   * away from it, so the loops carry no dependency and vectorize.
+   *
+   * @throws std::invalid_argument if the streams differ in length
+   */
+  void fill_row(int32_t left, int32_t y, std::span<Scalar> x_out, std::span<Scalar> y_out,
+                std::span<Scalar> z_out) const {
+    if (x_out.size() != y_out.size() || x_out.size() != z_out.size()) {
+      throw std::invalid_argument("Direction streams must have the same length.");
+    }
+
+    const auto first = direction(left, y);
+    const auto fill = [&](std::span<Scalar> out, Scalar start, Scalar step) {
+      for (size_t i = 0; i < out.size(); ++i) { out[i] = start + static_cast<Scalar>(i) * step; }
+    };
+    fill(x_out, first.template get<"x">(), m_pixel_step[0]);
+    fill(y_out, first.template get<"y">(), m_pixel_step[1]);
+    fill(z_out, first.template get<"z">(), m_pixel_step[2]);
+  }
+
+  /**
+   * @brief Change in direction from one pixel to the next along a row
+   */
+  [[nodiscard]] constexpr Vec3<Scalar> pixel_step() const {
+    return Vec3<Scalar>{m_pixel_step[0], m_pixel_step[1], m_pixel_step[2]};
+  }
+
+  /**
+   * @brief Change in direction from one row to the next
+   */
+  [[nodiscard]] constexpr Vec3<Scalar> row_step() const {
+    return Vec3<Scalar>{m_row_step[0], m_row_step[1], m_row_step[2]};
+  }
+
+private:
+  std::array<Scalar, 3> m_pixel_step{};
+  std::array<Scalar, 3> m_row_step{};
+  std::array<Scalar, 3> m_center{};
+};
+
+using CameraRayGenerator = BasicCameraRayGenerator<double>;
+using CameraRayGeneratorF = BasicCameraRayGenerator<float>;
+
+/**
+ * @brief Project a world space point to canvas coordinates, the inverse of primary ray generation
+ * @return canvas position, or std::nullopt for points on or behind the camera plane
+ */
+template <typename CanvasType>
+constexpr std::optional<Vec2d> world_to_canvas(const Vec3d& point, const Viewport& viewport,
+                                               const CanvasType& canvas, const Camera& camera) {
+  const auto& rotation = camera.get<"rotation">();
+  const auto offset = point - camera.get<"origin">();
+  const std::array<double, 3> world{offset.get<"x">(), offset.get<"y">(), offset.get<"z">()};
+
+  // Rotations are orthonormal, so the transpose takes world space back to camera space
+  std::array<double, 3> local{0.0, 0.0, 0.0};
+  for (size_t i = 0; i < 3; ++i) {
+    for (size_t j = 0; j < 3; ++j) { local[i] += rotation[j][i] * world[j]; }
+  }
+
+  if (local[2] <= 0.0) { return std::nullopt; }
+
+  const double distance_camera_to_proj_plane = camera.get<"projection_plane">().get<"distance">();
+  const double scale = distance_camera_to_proj_plane / local[2];
+
+  const auto c_w = static_cast<double>(canvas.template get<"width">());
+  const auto c_h = static_cast<double>(canvas.template get<"height">());
+
+  return Vec2d{local[0] * scale * c_w / viewport.get<"width">(),
+               local[1] * scale * c_h / viewport.get<"height">()};
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_RAY_GENERATION_HPP
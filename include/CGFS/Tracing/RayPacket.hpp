@@ -0,0 +1,280 @@
+/**
+ * @brief Coherent ray packets for primary rays
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_RAY_PACKET_HPP
+#define CGFS_RAY_PACKET_HPP
+
+#include "CGFS/Accel/AABB.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/ShapeIntersection.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace cgfs {
+
+/**
+ * @brief A bundle of rays sharing one origin, stored one array per direction component
+ *
+ * Lanes whose active flag is false are ignored by every packet query and keep an empty result.
+ * Primary rays from a pinhole camera all start at the camera origin, which lets the packet
+ * queries compute origin-to-object terms once per object instead of once per ray.
+ *
+ * @tparam Lanes number of rays in the packet
+ */
+template <size_t Lanes>
+struct RayPacket {
+  static constexpr size_t lanes = Lanes;
+
+  Origin origin{};
+  std::array<double, Lanes> direction_x{};
+  std::array<double, Lanes> direction_y{};
+  std::array<double, Lanes> direction_z{};
+  std::array<bool, Lanes> active{};
+
+  constexpr void set_direction(size_t lane, const Vec3d& direction) {
+    direction_x[lane] = direction.get<"x">();
+    direction_y[lane] = direction.get<"y">();
+    direction_z[lane] = direction.get<"z">();
+    active[lane] = true;
+  }
+
+  [[nodiscard]] constexpr Vec3d direction(size_t lane) const {
+    return Vec3d{direction_x[lane], direction_y[lane], direction_z[lane]};
+  }
+
+  [[nodiscard]] constexpr bool any_active() const {
+    return std::any_of(active.begin(), active.end(), [](bool lane) { return lane; });
+  }
+};
+
+template <size_t Lanes>
+using PacketIntersectionResult = std::array<ClosestIntersectionResult, Lanes>;
+
+namespace detail {
+
+/**
+ * @brief Test one sphere against every active lane, shrinking closest_t where it is hit
+ * @return per lane, whether this sphere became the closest hit
+ */
+template <size_t Lanes>
+std::array<bool, Lanes> intersect_packet_sphere(const RayPacket<Lanes>& packet,
+                                                const std::array<double, Lanes>& direction_dot,
+                                                double center_x, double center_y, double center_z,
+                                                double radius_sq, double t_min,
+                                                std::array<double, Lanes>& closest_t) {
+  const double cox = packet.origin.template get<"x">() - center_x;
+  const double coy = packet.origin.template get<"y">() - center_y;
+  const double coz = packet.origin.template get<"z">() - center_z;
+  const double c = cox * cox + coy * coy + coz * coz - radius_sq;
+
+  std::array<bool, Lanes> improved{};
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    if (!packet.active[lane]) { continue; }
+
+    const double half_b = cox * packet.direction_x[lane] + coy * packet.direction_y[lane] +
+                          coz * packet.direction_z[lane];
+    const double discriminant = half_b * half_b - direction_dot[lane] * c;
+    if (!(discriminant >= 0.0)) { continue; }
+
+    const double root = std::sqrt(discriminant);
+    const double t_near = (-half_b - root) / direction_dot[lane];
+    const double t_far = (-half_b + root) / direction_dot[lane];
+
+    if (t_near > t_min && t_near < closest_t[lane]) {
+      closest_t[lane] = t_near;
+      improved[lane] = true;
+    } else if (t_far > t_min && t_far < closest_t[lane]) {
+      closest_t[lane] = t_far;
+      improved[lane] = true;
+    }
+  }
+  return improved;
+}
+
+template <size_t Lanes>
+std::array<double, Lanes> direction_dots(const RayPacket<Lanes>& packet) {
+  std::array<double, Lanes> dots{};
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    dots[lane] = packet.direction_x[lane] * packet.direction_x[lane] +
+                 packet.direction_y[lane] * packet.direction_y[lane] +
+                 packet.direction_z[lane] * packet.direction_z[lane];
+  }
+  return dots;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Closest hit for every active lane of a packet against an uncompiled scene
+ *
+ * Each sphere is read once per packet rather than once per ray.
+ */
+template <size_t Lanes, size_t NumObjects, size_t NumLights>
+PacketIntersectionResult<Lanes> closest_intersection(const RayPacket<Lanes>& packet, double t_min,
+                                                     double t_max,
+                                                     const Scene<NumObjects, NumLights>& scene) {
+  const auto direction_dot = detail::direction_dots(packet);
+
+  std::array<double, Lanes> closest_t;
+  closest_t.fill(t_max);
+  std::array<Sphere const*, Lanes> closest_sphere{};
+
+  for (const auto& sphere : scene.template get<"objects">()) {
+    const auto& center = sphere.template get<"center">();
+    const double radius = sphere.template get<"radius">();
+    const auto improved = detail::intersect_packet_sphere(
+        packet, direction_dot, center.template get<"x">(), center.template get<"y">(),
+        center.template get<"z">(), radius * radius, t_min, closest_t);
+
+    for (size_t lane{0}; lane < Lanes; ++lane) {
+      if (improved[lane]) { closest_sphere[lane] = &sphere; }
+    }
+  }
+
+  PacketIntersectionResult<Lanes> result;
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    const double t = closest_sphere[lane] != nullptr ? closest_t[lane] : basically_infinity;
+    result[lane] = ClosestIntersectionResult{closest_sphere[lane], t, ShapeHit{}};
+  }
+  return result;
+}
+
+/**
+ * @brief Closest hit for every active lane of a packet against a compiled scene
+ *
+ * The packet walks the BVH as a unit: a node is entered when any active lane overlaps it, so
+ * node fetches and the traversal stack are shared by all lanes, and each lane keeps its own
+ * closest distance for culling inside the box test.
+ */
+template <size_t Lanes>
+PacketIntersectionResult<Lanes> closest_intersection(const RayPacket<Lanes>& packet, double t_min,
+                                                     double t_max, const CompiledScene& scene) {
+  const auto& spheres = scene.get<"spheres">();
+
+  const auto direction_dot = detail::direction_dots(packet);
+
+  std::array<double, Lanes> inv_x;
+  std::array<double, Lanes> inv_y;
+  std::array<double, Lanes> inv_z;
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    inv_x[lane] = 1.0 / packet.direction_x[lane];
+    inv_y[lane] = 1.0 / packet.direction_y[lane];
+    inv_z[lane] = 1.0 / packet.direction_z[lane];
+  }
+
+  // Shapes sit outside the BVH and are tested per lane; their hits bound the walk below
+  std::array<ClosestIntersectionResult, Lanes> shape_hits;
+  std::array<double, Lanes> closest_t;
+  closest_t.fill(t_max);
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    if (!packet.active[lane]) { continue; }
+    shape_hits[lane] = closest_intersection(packet.origin, packet.direction(lane), t_min, t_max,
+                                            scene.get<"shapes">());
+    if (is_hit(shape_hits[lane])) {
+      closest_t[lane] = shape_hits[lane].template get<"closest_t">();
+    }
+  }
+
+  std::array<uint32_t, Lanes> closest_index;
+  closest_index.fill(no_sphere);
+
+  const double ox = packet.origin.template get<"x">();
+  const double oy = packet.origin.template get<"y">();
+  const double oz = packet.origin.template get<"z">();
+
+  const auto box_test = [&](const AABB& bounds) {
+    const double min_x = bounds.get<"min">().get<"x">() - ox;
+    const double min_y = bounds.get<"min">().get<"y">() - oy;
+    const double min_z = bounds.get<"min">().get<"z">() - oz;
+    const double max_x = bounds.get<"max">().get<"x">() - ox;
+    const double max_y = bounds.get<"max">().get<"y">() - oy;
+    const double max_z = bounds.get<"max">().get<"z">() - oz;
+
+    double nearest = basically_infinity;
+    for (size_t lane{0}; lane < Lanes; ++lane) {
+      if (!packet.active[lane]) { continue; }
+
+      const double tx1 = min_x * inv_x[lane];
+      const double tx2 = max_x * inv_x[lane];
+      const double ty1 = min_y * inv_y[lane];
+      const double ty2 = max_y * inv_y[lane];
+      const double tz1 = min_z * inv_z[lane];
+      const double tz2 = max_z * inv_z[lane];
+
+      const double t_enter = std::max(
+          std::max(std::max(t_min, std::min(tx1, tx2)), std::min(ty1, ty2)), std::min(tz1, tz2));
+      const double t_exit = std::min(
+          std::min(std::min(closest_t[lane], std::max(tx1, tx2)), std::max(ty1, ty2)),
+          std::max(tz1, tz2));
+
+      if (t_enter <= t_exit) { nearest = std::min(nearest, t_enter); }
+    }
+    return nearest;
+  };
+
+  const auto visit_leaf = [&](uint32_t first, uint32_t count) {
+    for (uint32_t i{first}; i < first + count; ++i) {
+      const auto improved = detail::intersect_packet_sphere(
+          packet, direction_dot, spheres.center_x()[i], spheres.center_y()[i],
+          spheres.center_z()[i], spheres.radius_sq()[i], t_min, closest_t);
+
+      for (size_t lane{0}; lane < Lanes; ++lane) {
+        if (improved[lane]) { closest_index[lane] = i; }
+      }
+    }
+    return false;
+  };
+
+  scene.get<"bvh">().traverse_with(box_test, visit_leaf);
+
+  PacketIntersectionResult<Lanes> result;
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    if (closest_index[lane] != no_sphere) {
+      result[lane] = sphere_hit(scene, closest_index[lane], packet.origin, packet.direction(lane),
+                                closest_t[lane]);
+    } else if (is_hit(shape_hits[lane])) {
+      result[lane] = shape_hits[lane];
+    } else {
+      result[lane] = ClosestIntersectionResult{nullptr, basically_infinity, ShapeHit{}};
+    }
+  }
+  return result;
+}
+
+/**
+ * @brief Trace a packet of primary rays
+ *
+ * The primary hits are found together; shading and reflections then run per lane, since those
+ * rays no longer share an origin.
+ *
+ * @return the color of every lane; inactive lanes are left default constructed
+ */
+template <size_t Lanes, typename SceneType>
+std::array<Color3, Lanes> trace_packet(const RayPacket<Lanes>& packet, double t_min, double t_max,
+                                       const TraceSettings& settings, const SceneType& scene) {
+  const auto intersections = closest_intersection(packet, t_min, t_max, scene);
+
+  std::array<Color3, Lanes> colors{};
+  for (size_t lane{0}; lane < Lanes; ++lane) {
+    if (!packet.active[lane]) { continue; }
+    colors[lane] = to_color3(trace_radiance(packet.origin, packet.direction(lane),
+                                            intersections[lane], settings, scene));
+  }
+  return colors;
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_RAY_PACKET_HPP
@@ -0,0 +1,268 @@
+/**
+ * @brief Diffuse, specular and shadow lighting at a surface point
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_SHADING_HPP
+#define CGFS_SHADING_HPP
+
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/CompiledSceneF.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Lighting/PreparedLights.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Precision.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/ShadowCache.hpp"
+
+#include <cstdint>
+#include <type_traits>
+
+namespace cgfs {
+
+/**
+ * @brief Diffuse plus specular intensity a light adds at a point, ignoring shadows
+ * @param normal unit surface normal
+ * @param direction_to_cam direction from the point back to the viewer
+ * @param specular specular exponent, -1 for a matte surface
+ * @param light_intensity intensity of the light
+ * @param direction direction from the point towards the light
+ * @param direction_length length of direction, known up front for prepared directional lights
+ * @tparam Precision precision policy for lengths and the specular power, see Precision.hpp
+ * @tparam Scalar float or double, taken from the vectors
+ */
+template <typename Precision = ExactMath, typename Scalar>
+constexpr Scalar diffuse_specular_intensity(const Vec3<Scalar>& normal,
+                                            const Vec3<Scalar>& direction_to_cam,
+                                            std::type_identity_t<Scalar> specular,
+                                            std::type_identity_t<Scalar> light_intensity,
+                                            const Vec3<Scalar>& direction,
+                                            std::type_identity_t<Scalar> direction_length) {
+  Scalar intensity = 0;
+
+  const auto n_dot_light = dot(normal, direction);
+
+  // Diffuse
+  if (n_dot_light > 0) {
+    intensity += light_intensity * n_dot_light / (Precision::length(normal) * direction_length);
+  }
+
+  // Specular
+  if (specular != -1) {
+    const auto reflection = normal * (static_cast<Scalar>(2) * n_dot_light) - direction;
+    const auto r_dot_v = dot(reflection, direction_to_cam);
+
+    if (r_dot_v > 0) {
+      intensity +=
+          light_intensity *
+          Precision::pow(r_dot_v / (Precision::length(reflection) *
+                                    Precision::length(direction_to_cam)),
+                         specular);
+    }
+  }
+
+  return intensity;
+}
+
+template <typename Precision = ExactMath, typename Scalar>
+constexpr Scalar diffuse_specular_intensity(const Vec3<Scalar>& normal,
+                                            const Vec3<Scalar>& direction_to_cam,
+                                            std::type_identity_t<Scalar> specular,
+                                            std::type_identity_t<Scalar> light_intensity,
+                                            const Vec3<Scalar>& direction) {
+  return diffuse_specular_intensity<Precision>(normal, direction_to_cam, specular,
+                                               light_intensity, direction,
+                                               Precision::length(direction));
+}
+
+/**
+ * @brief Unshadowed contribution of every point and directional light at a point
+ *
+ * Calls emit(light_index, direction, t_max, intensity) for each light, point lights first,
+ * where direction and t_max describe the shadow ray towards the light. The ambient term is left
+ * to the caller. Local lights come last and are found through their BVH, so only those whose
+ * influence radius reaches the point are emitted.
+ *
+ * @tparam Scalar float or double, taken from the vectors; the lights must match
+ */
+template <typename Precision = ExactMath, typename Scalar, typename Emit>
+constexpr void for_each_light_sample(const Vec3<Scalar>& point, const Vec3<Scalar>& normal,
+                                     const Vec3<Scalar>& direction_to_cam,
+                                     std::type_identity_t<Scalar> specular,
+                                     const BasicPreparedLights<Scalar>& lights, Emit&& emit) {
+  uint32_t light_index = 0;
+
+  for (const auto& point_light : lights.template get<"point_lights">()) {
+    const auto direction = point_light.template get<"position">() - point;
+    emit(light_index++, direction, Scalar{1},
+         diffuse_specular_intensity<Precision>(normal, direction_to_cam, specular,
+                                               point_light.template get<"intensity">(),
+                                               direction));
+  }
+
+  for (const auto& directional_light : lights.template get<"directional_lights">()) {
+    emit(light_index++, directional_light.template get<"shadow_direction">(),
+         static_cast<Scalar>(basically_infinity),
+         diffuse_specular_intensity<Precision>(normal, direction_to_cam, specular,
+                                               directional_light.template get<"intensity">(),
+                                               directional_light.template get<"direction">(),
+                                               Scalar{1}));
+  }
+
+  const auto& local_lights = lights.template get<"local_lights">();
+  if (local_lights.empty()) { return; }
+
+  const auto wide_point = vec3_cast<double>(point);
+  lights.template get<"local_light_bvh">().traverse_with(
+      [&](const AABB& bounds) { return contains(bounds, wide_point) ? 0.0 : basically_infinity; },
+      [&](uint32_t first, uint32_t count) {
+        for (uint32_t i{first}; i < first + count; ++i) {
+          const auto direction = local_lights[i].template get<"position">() - point;
+          const Scalar radius = local_lights[i].template get<"radius">();
+          if (dot(direction, direction) > radius * radius) { continue; }
+          emit(light_index + i, direction, Scalar{1},
+               diffuse_specular_intensity<Precision>(normal, direction_to_cam, specular,
+                                                     local_lights[i].template get<"intensity">(),
+                                                     direction));
+        }
+        return false;
+      });
+}
+
+template <typename Precision = ExactMath, typename SceneType>
+constexpr double compute_lighting(const Vec3d& point, const Vec3d& normal,
+                                  const Vec3d& direction_to_cam, double specular,
+                                  const SceneType& scene) {
+  double cumulative_intensity = 0.0;
+
+  constexpr auto compute_diffuse_specular =
+      [](const Vec3d& inner_point, const Vec3d& inner_normal,
+         const Vec3d& inner_direction_to_cam, double inner_specular,
+         const SceneType& inner_scene, double light_intensity,
+         const auto& direction, double t_max) {
+        if (occluded(inner_point, direction, 0.001, t_max, inner_scene)) { return 0.0; }
+
+        return diffuse_specular_intensity<Precision>(inner_normal, inner_direction_to_cam,
+                                                     inner_specular, light_intensity, direction);
+      };
+
+  for (const auto& light : scene.template get<"lights">()) {
+    cumulative_intensity += light.visit(
+        [](const AmbientLightProperties& ambient_light) -> double {
+          return ambient_light.get<"intensity">();
+        },
+        [&compute_diffuse_specular, &point, &specular, &normal, &direction_to_cam,
+         &scene](const PointLightProperties& point_light) -> double {
+          const auto direction = point_light.get<"position">() - point;
+          return compute_diffuse_specular(point, normal, direction_to_cam, specular, scene,
+                                          point_light.get<"intensity">(), direction, 1.0);
+        },
+        [&compute_diffuse_specular, &point, &specular, &normal, &direction_to_cam,
+         &scene](const DirectionalLightProperties& directional_light) -> double {
+          const auto direction = directional_light.get<"direction">();
+
+          return compute_diffuse_specular(point, normal, direction_to_cam, specular, scene,
+                                          directional_light.get<"intensity">(), direction,
+                                          basically_infinity);
+        });
+  }
+
+  return cumulative_intensity;
+}
+
+/**
+ * @brief Lighting at a point of a scene that keeps no blocker cache, which is left untouched
+ */
+template <typename Precision = ExactMath, typename SceneType, typename Scalar>
+constexpr Scalar compute_lighting(const Vec3<Scalar>& point, const Vec3<Scalar>& normal,
+                                  const Vec3<Scalar>& direction_to_cam,
+                                  std::type_identity_t<Scalar> specular, const SceneType& scene,
+                                  ShadowCache& /*cache*/) {
+  return compute_lighting<Precision>(point, normal, direction_to_cam, specular, scene);
+}
+
+namespace detail {
+
+/**
+ * @brief Prepared light loop shared by the compiled scene overloads, cache may be null
+ */
+template <typename Precision, typename SceneType>
+scene_scalar_t<SceneType> prepared_lighting(const Vec3<scene_scalar_t<SceneType>>& point,
+                                            const Vec3<scene_scalar_t<SceneType>>& normal,
+                                            const Vec3<scene_scalar_t<SceneType>>& direction_to_cam,
+                                            scene_scalar_t<SceneType> specular,
+                                            const SceneType& scene, ShadowCache* cache) {
+  using Scalar = scene_scalar_t<SceneType>;
+  const auto t_min = static_cast<Scalar>(0.001);
+
+  const auto& lights = scene.template get<"prepared_lights">();
+  Scalar cumulative_intensity = lights.template get<"ambient">();
+
+  for_each_light_sample<Precision>(
+      point, normal, direction_to_cam, specular, lights,
+      [&](uint32_t light_index, const Vec3<Scalar>& direction, Scalar t_max, Scalar intensity) {
+        if (intensity == Scalar{0}) { return; }
+        const bool blocked =
+            cache != nullptr ? occluded(point, direction, t_min, t_max, scene, *cache, light_index)
+                             : occluded(point, direction, t_min, t_max, scene);
+        if (!blocked) { cumulative_intensity += intensity; }
+      });
+
+  return cumulative_intensity;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Lighting at a point of a compiled scene, from its prepared lights
+ *
+ * Starts from the folded ambient term, and only casts a shadow ray for lights that would add
+ * something. Equal to lighting from the scene's light list up to rounding, within a relative
+ * 1e-12: the ambient terms are summed first and directional lights are normalized once, so the
+ * sums round differently.
+ */
+template <typename Precision = ExactMath>
+double compute_lighting(const Vec3d& point, const Vec3d& normal, const Vec3d& direction_to_cam,
+                        double specular, const CompiledScene& scene) {
+  return detail::prepared_lighting<Precision>(point, normal, direction_to_cam, specular, scene,
+                                              nullptr);
+}
+
+/**
+ * @brief Lighting at a point of a compiled scene, trying each light's last blocker in cache
+ * first; the result is the same as without the cache
+ */
+template <typename Precision = ExactMath>
+double compute_lighting(const Vec3d& point, const Vec3d& normal, const Vec3d& direction_to_cam,
+                        double specular, const CompiledScene& scene, ShadowCache& cache) {
+  return detail::prepared_lighting<Precision>(point, normal, direction_to_cam, specular, scene,
+                                              &cache);
+}
+
+/**
+ * @brief Lighting at a point of a single precision scene, from its prepared lights
+ */
+template <typename Precision = ExactMath>
+float compute_lighting(const Vec3f& point, const Vec3f& normal, const Vec3f& direction_to_cam,
+                       float specular, const CompiledSceneF& scene) {
+  return detail::prepared_lighting<Precision>(point, normal, direction_to_cam, specular, scene,
+                                              nullptr);
+}
+
+/**
+ * @brief Lighting at a point of a single precision scene, with the blocker cache
+ */
+template <typename Precision = ExactMath>
+float compute_lighting(const Vec3f& point, const Vec3f& normal, const Vec3f& direction_to_cam,
+                       float specular, const CompiledSceneF& scene, ShadowCache& cache) {
+  return detail::prepared_lighting<Precision>(point, normal, direction_to_cam, specular, scene,
+                                              &cache);
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_SHADING_HPP
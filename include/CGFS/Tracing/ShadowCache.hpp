@@ -0,0 +1,120 @@
+/**
+ * @brief Last occluder cache for shadow rays of compiled scenes
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_SHADOW_CACHE_HPP
+#define CGFS_SHADOW_CACHE_HPP
+
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/CompiledSceneF.hpp"
+#include "CGFS/Math.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief The sphere that last blocked each light's shadow rays
+ *
+ * Neighbouring shade points are usually shadowed by the same sphere, so testing it before the
+ * full scene query settles most shadowed samples with one sphere test. An entry is only a hint:
+ * testing the wrong sphere first can cost a test but never changes an answer, so a cache may be
+ * shared across scenes and frames without being cleared.
+ */
+class ShadowCache {
+public:
+  /**
+   * @return leaf order slot of the light's last blocker, or no_sphere
+   */
+  [[nodiscard]] uint32_t blocker(uint32_t light) const {
+    return light < m_blockers.size() ? m_blockers[light] : no_sphere;
+  }
+
+  void remember(uint32_t light, uint32_t slot) {
+    if (light >= m_blockers.size()) { m_blockers.resize(light + 1, no_sphere); }
+    m_blockers[light] = slot;
+  }
+
+  void clear() { m_blockers.clear(); }
+
+private:
+  std::vector<uint32_t> m_blockers;
+};
+
+/**
+ * @brief The calling thread's own cache, so render workers never share entries
+ */
+inline ShadowCache& thread_shadow_cache() {
+  thread_local ShadowCache cache;
+  return cache;
+}
+
+namespace detail {
+
+/**
+ * @brief Cached shadow query shared by the double and single precision compiled scenes
+ *
+ * Shapes and boxes are tested in double, on the ray widened once, like the scenes' own queries.
+ */
+template <typename Scalar, typename SceneType>
+bool cached_occluded(const Vec3<Scalar>& origin, const Vec3<Scalar>& direction, Scalar t_min,
+                     Scalar t_max, const SceneType& scene, ShadowCache& cache, uint32_t light) {
+  const auto& spheres = scene.template get<"spheres">();
+
+  const auto cached = cache.blocker(light);
+  if (cached < spheres.size() &&
+      any_sphere_hit(spheres, origin, direction, t_min, t_max, cached, cached + 1)) {
+    return true;
+  }
+
+  const auto wide_origin = vec3_cast<double>(origin);
+  const auto wide_direction = vec3_cast<double>(direction);
+  if (occluded(wide_origin, wide_direction, t_min, t_max, scene.template get<"shapes">())) {
+    return true;
+  }
+
+  uint32_t blocker = no_sphere;
+  double box_t_max = t_max;
+  scene.template get<"bvh">().traverse(
+      wide_origin, wide_direction, t_min, box_t_max, [&](uint32_t first, uint32_t count) {
+        blocker = first_sphere_hit(spheres, origin, direction, t_min, t_max, first, first + count);
+        return blocker != no_sphere;
+      });
+  if (blocker == no_sphere) { return false; }
+
+  cache.remember(light, blocker);
+  return true;
+}
+
+}  // namespace detail
+
+/**
+ * @brief Shadow query of a compiled scene that tries the light's last blocker first
+ *
+ * Answers exactly like occluded on the scene, and records whichever sphere blocked the ray.
+ * Entries survive unblocked rays, since the next point over may well be behind the same sphere.
+ *
+ * @param light index the light's samples share, as given by for_each_light_sample
+ */
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const CompiledScene& scene, ShadowCache& cache, uint32_t light) {
+  return detail::cached_occluded(origin, direction, t_min, t_max, scene, cache, light);
+}
+
+/**
+ * @brief Shadow query of a single precision scene that tries the light's last blocker first
+ */
+inline bool occluded(const OriginF& origin, const Vec3f& direction, float t_min, float t_max,
+                     const CompiledSceneF& scene, ShadowCache& cache, uint32_t light) {
+  return detail::cached_occluded(origin, direction, t_min, t_max, scene, cache, light);
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_SHADOW_CACHE_HPP
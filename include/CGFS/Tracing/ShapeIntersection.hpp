@@ -0,0 +1,279 @@
+/**
+ * @brief Ray intersection for planes, boxes, discs, triangles, meshes and instances
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_SHAPE_INTERSECTION_HPP
+#define CGFS_SHAPE_INTERSECTION_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Objects/Shapes.hpp"
+#include "CGFS/Tracing/InstanceIntersection.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/MeshIntersection.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace cgfs {
+
+namespace detail {
+
+/**
+ * @brief Unit version of normal, flipped if needed so it faces against direction
+ */
+constexpr Vec3d facing(const Vec3d& normal, const Vec3d& direction) {
+  const auto unit = normal / length(normal);
+  return dot(unit, direction) > 0.0 ? -unit : unit;
+}
+
+/**
+ * @brief Outward normal of the box face closest to a point on its surface
+ */
+constexpr Vec3d box_normal(const Box& box, const Vec3d& point) {
+  const auto center = 0.5 * (box.get<"min">() + box.get<"max">());
+  const auto half = 0.5 * (box.get<"max">() - box.get<"min">());
+  const auto local = point - center;
+
+  const double x = local.get<"x">() / half.get<"x">();
+  const double y = local.get<"y">() / half.get<"y">();
+  const double z = local.get<"z">() / half.get<"z">();
+
+  if (std::abs(x) >= std::abs(y) && std::abs(x) >= std::abs(z)) {
+    return Vec3d{x < 0.0 ? -1.0 : 1.0, 0.0, 0.0};
+  }
+  if (std::abs(y) >= std::abs(z)) { return Vec3d{0.0, y < 0.0 ? -1.0 : 1.0, 0.0}; }
+  return Vec3d{0.0, 0.0, z < 0.0 ? -1.0 : 1.0};
+}
+
+/**
+ * @brief Parametric span {enter, exit} of a ray inside one slab of a box
+ *
+ * A ray parallel to the slab is inside it everywhere or nowhere. It is handled on its own,
+ * because an origin on the slab plane would otherwise give 0 * inf = NaN, and the hit would
+ * depend on the comparison order.
+ */
+constexpr std::pair<double, double> slab_span(double origin, double direction, double lo,
+                                              double hi) {
+  constexpr double inf = std::numeric_limits<double>::infinity();
+  if (direction == 0.0) {
+    return origin >= lo && origin <= hi ? std::pair{-inf, inf} : std::pair{inf, -inf};
+  }
+
+  const double t_lo = (lo - origin) / direction;
+  const double t_hi = (hi - origin) / direction;
+  return {std::min(t_lo, t_hi), std::max(t_lo, t_hi)};
+}
+
+}  // namespace detail
+
+/**
+ * @return parametric distance of the hit, or basically_infinity if the ray is parallel
+ */
+constexpr double intersect_ray_plane(const Origin& origin, const Vec3d& direction,
+                                     const Plane& plane) {
+  const auto& normal = plane.get<"normal">();
+  const double denominator = dot(normal, direction);
+  if (denominator == 0.0) { return basically_infinity; }
+
+  return (plane.get<"offset">() - dot(normal, origin)) / denominator;
+}
+
+/**
+ * @return parametric distance of the hit, or basically_infinity on a miss
+ */
+constexpr double intersect_ray_disc(const Origin& origin, const Vec3d& direction,
+                                    const Disc& disc) {
+  const auto& normal = disc.get<"normal">();
+  const double denominator = dot(normal, direction);
+  if (denominator == 0.0) { return basically_infinity; }
+
+  const auto& center = disc.get<"center">();
+  const double t = dot(normal, center - origin) / denominator;
+  const auto offset = origin + (t * direction) - center;
+  const double radius = disc.get<"radius">();
+
+  return dot(offset, offset) <= radius * radius ? t : basically_infinity;
+}
+
+/**
+ * @return nearest parametric distance past t_min where the ray crosses the box surface, or
+ * basically_infinity on a miss
+ */
+constexpr double intersect_ray_box(const Origin& origin, const Vec3d& direction, double t_min,
+                                   const Box& box) {
+  const auto [tx_enter, tx_exit] = detail::slab_span(origin.get<"x">(), direction.get<"x">(),
+                                                     box.get<"min">().get<"x">(),
+                                                     box.get<"max">().get<"x">());
+  const auto [ty_enter, ty_exit] = detail::slab_span(origin.get<"y">(), direction.get<"y">(),
+                                                     box.get<"min">().get<"y">(),
+                                                     box.get<"max">().get<"y">());
+  const auto [tz_enter, tz_exit] = detail::slab_span(origin.get<"z">(), direction.get<"z">(),
+                                                     box.get<"min">().get<"z">(),
+                                                     box.get<"max">().get<"z">());
+
+  const double t_enter = std::max({tx_enter, ty_enter, tz_enter});
+  const double t_exit = std::min({tx_exit, ty_exit, tz_exit});
+
+  if (t_enter > t_exit) { return basically_infinity; }
+  if (t_enter > t_min) { return t_enter; }
+  return t_exit > t_min ? t_exit : basically_infinity;
+}
+
+/**
+ * @brief Möller-Trumbore ray-triangle test
+ * @return parametric distance of the hit, or basically_infinity on a miss
+ */
+constexpr double intersect_ray_triangle(const Origin& origin, const Vec3d& direction,
+                                        const Triangle& triangle) {
+  const auto& v0 = triangle.get<"v0">();
+  const auto edge1 = triangle.get<"v1">() - v0;
+  const auto edge2 = triangle.get<"v2">() - v0;
+
+  const auto p = cross(direction, edge2);
+  const double determinant = dot(edge1, p);
+  if (determinant == 0.0) { return basically_infinity; }
+  const double inv_determinant = 1.0 / determinant;
+
+  const auto s = origin - v0;
+  const double u = dot(s, p) * inv_determinant;
+  if (u < 0.0 || u > 1.0) { return basically_infinity; }
+
+  const auto q = cross(s, edge1);
+  const double v = dot(direction, q) * inv_determinant;
+  if (v < 0.0 || u + v > 1.0) { return basically_infinity; }
+
+  return dot(edge2, q) * inv_determinant;
+}
+
+/**
+ * @brief Closest hit among a scene's non-sphere primitives
+ *
+ * Runs one loop per shape type; the surface normal is only worked out when a hit becomes the
+ * closest so far.
+ */
+inline ClosestIntersectionResult closest_intersection(const Origin& origin, const Vec3d& direction,
+                                                      double t_min, double t_max,
+                                                      const ShapeArrays& shapes) {
+  double closest_t_value = t_max;
+  MaterialProperties const* closest_material = nullptr;
+  Vec3d closest_normal{};
+  const void* closest_object = nullptr;
+
+  const auto closer = [&](double t) { return t > t_min && t < closest_t_value; };
+
+  for (const auto& plane : shapes.get<"planes">()) {
+    const double t = intersect_ray_plane(origin, direction, plane);
+    if (!closer(t)) { continue; }
+    closest_t_value = t;
+    closest_material = &plane.get<"material">();
+    closest_object = &plane;
+    closest_normal = detail::facing(plane.get<"normal">(), direction);
+  }
+
+  for (const auto& box : shapes.get<"boxes">()) {
+    const double t = intersect_ray_box(origin, direction, t_min, box);
+    if (!closer(t)) { continue; }
+    closest_t_value = t;
+    closest_material = &box.get<"material">();
+    closest_object = &box;
+    closest_normal =
+        detail::facing(detail::box_normal(box, origin + (t * direction)), direction);
+  }
+
+  for (const auto& disc : shapes.get<"discs">()) {
+    const double t = intersect_ray_disc(origin, direction, disc);
+    if (!closer(t)) { continue; }
+    closest_t_value = t;
+    closest_material = &disc.get<"material">();
+    closest_object = &disc;
+    closest_normal = detail::facing(disc.get<"normal">(), direction);
+  }
+
+  for (const auto& triangle : shapes.get<"triangles">()) {
+    const double t = intersect_ray_triangle(origin, direction, triangle);
+    if (!closer(t)) { continue; }
+    closest_t_value = t;
+    closest_material = &triangle.get<"material">();
+    closest_object = &triangle;
+    const auto& v0 = triangle.get<"v0">();
+    closest_normal = detail::facing(
+        cross(triangle.get<"v1">() - v0, triangle.get<"v2">() - v0), direction);
+  }
+
+  ClosestIntersectionResult closest{nullptr, basically_infinity, ShapeHit{}};
+  if (closest_material != nullptr) {
+    closest = ClosestIntersectionResult{
+        nullptr, closest_t_value, ShapeHit{closest_material, closest_normal, closest_object, true}};
+  }
+
+  for (const auto& mesh : shapes.get<"meshes">()) {
+    const auto hit = closest_intersection(origin, direction, t_min, closest_t_value, mesh);
+    if (!is_hit(hit)) { continue; }
+    closest_t_value = hit.get<"closest_t">();
+    closest = hit;
+  }
+
+  for (const auto& instances : shapes.get<"instances">()) {
+    const auto hit = closest_intersection(origin, direction, t_min, closest_t_value, instances);
+    if (!is_hit(hit)) { continue; }
+    closest_t_value = hit.get<"closest_t">();
+    closest = hit;
+  }
+
+  return closest;
+}
+
+/**
+ * @brief Any-hit query over a scene's non-sphere primitives
+ */
+inline bool occluded(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                     const ShapeArrays& shapes) {
+  const auto inside = [&](double t) { return t > t_min && t < t_max; };
+
+  return std::any_of(shapes.get<"planes">().begin(), shapes.get<"planes">().end(),
+                     [&](const Plane& plane) {
+                       return inside(intersect_ray_plane(origin, direction, plane));
+                     }) ||
+         std::any_of(shapes.get<"boxes">().begin(), shapes.get<"boxes">().end(),
+                     [&](const Box& box) {
+                       return inside(intersect_ray_box(origin, direction, t_min, box));
+                     }) ||
+         std::any_of(shapes.get<"discs">().begin(), shapes.get<"discs">().end(),
+                     [&](const Disc& disc) {
+                       return inside(intersect_ray_disc(origin, direction, disc));
+                     }) ||
+         std::any_of(shapes.get<"triangles">().begin(), shapes.get<"triangles">().end(),
+                     [&](const Triangle& triangle) {
+                       return inside(intersect_ray_triangle(origin, direction, triangle));
+                     }) ||
+         std::any_of(shapes.get<"meshes">().begin(), shapes.get<"meshes">().end(),
+                     [&](const TriangleMesh& mesh) {
+                       return occluded(origin, direction, t_min, t_max, mesh);
+                     }) ||
+         std::any_of(shapes.get<"instances">().begin(), shapes.get<"instances">().end(),
+                     [&](const InstanceSet& instances) {
+                       return occluded(origin, direction, t_min, t_max, instances);
+                     });
+}
+
+/**
+ * @brief Combine a shape query with a sphere query that was bounded by the shape hit
+ *
+ * The sphere query only reports hits closer than the shape hit, so any hit it has wins.
+ */
+constexpr ClosestIntersectionResult closer_hit(const ClosestIntersectionResult& shape_hit,
+                                               const ClosestIntersectionResult& sphere_hit) {
+  return is_hit(sphere_hit) ? sphere_hit : shape_hit;
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_SHAPE_INTERSECTION_HPP
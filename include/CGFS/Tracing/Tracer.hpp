@@ -0,0 +1,269 @@
+/**
+ * @brief Whitted-style ray tracers, recursive and iterative
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_TRACER_HPP
+#define CGFS_TRACER_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/Shading.hpp"
+#include "CGFS/Tracing/ShadowCache.hpp"
+
+#include <algorithm>
+#include <array>
+#include <type_traits>
+
+namespace cgfs {
+
+constexpr Color3 scale_by_intensity(const Color3& color, double intensity) {
+  return Color3{static_cast<uint8_t>(std::clamp(
+                    static_cast<double>(color.get<"r">()) * intensity, 0.0, 255.0)),
+                static_cast<uint8_t>(std::clamp(
+                    static_cast<double>(color.get<"g">()) * intensity, 0.0, 255.0)),
+                static_cast<uint8_t>(std::clamp(
+                    static_cast<double>(color.get<"b">()) * intensity, 0.0, 255.0))};
+}
+
+/**
+ * @brief Local color of a hit in [0, 255] units, saturated per channel but not rounded
+ *
+ * Like scale_by_intensity, a highlight saturates before the reflection blend, so the iterative
+ * tracers weight a mirror's local color exactly as the recursive tracer does.
+ */
+constexpr RGB64F local_radiance(const Color3& color, double intensity) {
+  return RGB64F{std::clamp(static_cast<double>(color.get<"r">()) * intensity, 0.0, 255.0),
+                std::clamp(static_cast<double>(color.get<"g">()) * intensity, 0.0, 255.0),
+                std::clamp(static_cast<double>(color.get<"b">()) * intensity, 0.0, 255.0)};
+}
+
+template <typename Precision = ExactMath, typename SceneType>
+constexpr Color3 trace_ray(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                           int recursion_depth, const SceneType& scene);
+
+/**
+ * @brief Shade the result of a closest intersection query, following reflections
+ *
+ * Split from trace_ray so callers that find hits some other way, like packet tracing, shade
+ * them exactly as trace_ray would.
+ */
+template <typename Precision = ExactMath, typename SceneType>
+constexpr Color3 shade_intersection(const Origin& origin, const Vec3d& direction,
+                                    const ClosestIntersectionResult& intersection,
+                                    int recursion_depth, const SceneType& scene) {
+  if (!is_hit(intersection)) { return scene.template get<"background_color">(); }
+
+  const auto& material = hit_material(intersection);
+  const auto point = origin + (intersection.get<"closest_t">() * direction);
+  const auto normal = hit_normal<Precision>(intersection, point);
+
+  const Color3 local_color = scale_by_intensity(
+      material.get<"color">(),
+      compute_lighting<Precision>(point, normal, -direction, material.get<"specular">(), scene));
+
+  const auto reflectiveness = material.get<"reflective">();
+  if (recursion_depth <= 0 or reflectiveness <= 0.0) { return local_color; }
+
+  const auto reflection = reflect_ray(-direction, normal);
+  const auto reflected_color =
+      trace_ray<Precision>(point, reflection, 0.001, basically_infinity, recursion_depth - 1,
+                           scene);
+
+  const auto scaled_local_color = scale_by_intensity(local_color, 1.0 - reflectiveness);
+  const auto scaled_reflected_color = scale_by_intensity(reflected_color, reflectiveness);
+
+  return scaled_local_color + scaled_reflected_color;
+}
+
+/**
+ * @brief Trace a ray through a scene, following reflections up to recursion_depth bounces
+ *
+ * SceneType is either a Scene or a CompiledScene; intersection queries resolve to the overload
+ * for that type, so compiled scenes are traced through their BVH. Precision picks the shading
+ * math, see Precision.hpp.
+ */
+template <typename Precision, typename SceneType>
+constexpr Color3 trace_ray(const Origin& origin, const Vec3d& direction, double t_min, double t_max,
+                           int recursion_depth, const SceneType& scene) {
+  return shade_intersection<Precision>(origin, direction,
+                            closest_intersection(origin, direction, t_min, t_max, scene),
+                            recursion_depth, scene);
+}
+
+/**
+ * @brief Path termination and shadow controls for the iterative tracer
+ *
+ * max_depth bounds the number of reflection bounces. A bounce is also skipped once the share of
+ * the pixel it could still change, its throughput, drops below min_contribution.
+ *
+ * shadow_cache opts compiled scenes into trying each light's last blocker first, from a cache
+ * kept per calling thread, see ShadowCache. Entries outlive the render and are shared by every
+ * scene the thread traces, which never changes an image but makes tracing stateful; without it
+ * shading keeps no state between calls.
+ */
+using TraceSettings = mguid::NamedTuple<mguid::NamedType<"max_depth", int>,
+                                        mguid::NamedType<"min_contribution", double>,
+                                        mguid::NamedType<"shadow_cache", bool>>;
+
+/**
+ * @brief Below half an 8 bit step of full scale a bounce cannot change the final pixel
+ */
+constexpr double default_min_contribution = 0.5 / 255.0;
+
+/**
+ * @brief A ray waiting on the iterative tracer's stack, with the weight its color carries
+ */
+template <typename Scalar>
+using BasicPendingRay = mguid::NamedTuple<mguid::NamedType<"origin", Vec3<Scalar>>,
+                                          mguid::NamedType<"direction", Vec3<Scalar>>,
+                                          mguid::NamedType<"depth", int>,
+                                          mguid::NamedType<"throughput", double>>;
+
+using PendingRay = BasicPendingRay<double>;
+
+/**
+ * @brief Capacity of the iterative tracer's ray stack
+ *
+ * A mirror hit spawns one ray per pop, so the stack never holds more than one; the headroom is
+ * for materials that split a path. A hit that would overflow it is shaded as a final bounce.
+ */
+constexpr size_t max_pending_rays = 8;
+
+/**
+ * @brief Path visitor that ignores everything, the default for trace_radiance
+ *
+ * A visitor gets on_hit(bounce, point) for every surface a path reaches and
+ * on_miss(bounce, origin, direction) for a ray that leaves the scene, where bounce 0 is the
+ * primary ray.
+ */
+struct NoPathVisitor {
+  template <typename Vec>
+  constexpr void on_hit(int, const Vec&) const {}
+  template <typename Vec>
+  constexpr void on_miss(int, const Vec&, const Vec&) const {}
+};
+
+/**
+ * @brief Shade a primary hit and follow its reflections without recursion
+ *
+ * Each level's local color saturates like the recursive tracer's, see local_radiance, but the
+ * weighted sum stays in unrounded double precision until the caller converts it once. Each path
+ * carries a throughput weight, so deep mirror chains cost no C++ stack and stop as soon as
+ * they can no longer affect the pixel. A bounce that is cut off leaves its full weight to the
+ * local color, which is what the recursive tracer does when it runs out of depth.
+ *
+ * @param origin origin of the primary ray
+ * @param direction direction of the primary ray
+ * @param primary_hit closest intersection of the primary ray
+ * @param settings termination controls
+ * @param scene scene to trace
+ * @param path_visitor observer of the surfaces the path reaches
+ * @tparam Precision shading math policy, see Precision.hpp
+ * @tparam HitType closest intersection result of the scene's own query
+ * @return linear color in [0, 255] units, not clamped as a whole
+ *
+ * Rays and hits are in the scene's scalar type, see scene_scalar_t; the color sums are double
+ * either way.
+ */
+template <typename Precision = ExactMath, typename SceneType, typename PathVisitor = NoPathVisitor,
+          typename HitType>
+constexpr RGB64F trace_radiance(const Vec3<scene_scalar_t<SceneType>>& origin,
+                                const Vec3<scene_scalar_t<SceneType>>& direction,
+                                const HitType& primary_hit, const TraceSettings& settings,
+                                const SceneType& scene, PathVisitor&& path_visitor = {}) {
+  using Scalar = scene_scalar_t<SceneType>;
+  using Ray = BasicPendingRay<Scalar>;
+
+  std::array<Ray, max_pending_rays> stack;
+  size_t stack_size = 0;
+
+  double red = 0.0;
+  double green = 0.0;
+  double blue = 0.0;
+  const auto accumulate = [&](const auto& color, double weight) {
+    red += weight * static_cast<double>(color.template get<"r">());
+    green += weight * static_cast<double>(color.template get<"g">());
+    blue += weight * static_cast<double>(color.template get<"b">());
+  };
+
+  Ray ray{origin, direction, settings.get<"max_depth">(), 1.0};
+  HitType hit = primary_hit;
+
+  while (true) {
+    const Vec3<Scalar>& ray_direction = ray.template get<"direction">();
+    const double throughput = ray.template get<"throughput">();
+
+    const int bounce = settings.get<"max_depth">() - ray.template get<"depth">();
+
+    if (!is_hit(hit)) {
+      path_visitor.on_miss(bounce, ray.template get<"origin">(), ray_direction);
+      accumulate(scene.template get<"background_color">(), throughput);
+    } else {
+      const MaterialProperties& material = hit_material(hit);
+
+      const Vec3<Scalar> point =
+          ray.template get<"origin">() + (hit.template get<"closest_t">() * ray_direction);
+      path_visitor.on_hit(bounce, point);
+      const Vec3<Scalar> normal = hit_normal<Precision>(hit, point);
+      const Vec3<Scalar> spawn = spawn_point(hit, point, normal);
+
+      const auto specular = static_cast<Scalar>(material.get<"specular">());
+      const double intensity =
+          settings.get<"shadow_cache">()
+              ? compute_lighting<Precision>(spawn, normal, -ray_direction, specular, scene,
+                                            thread_shadow_cache())
+              : compute_lighting<Precision>(spawn, normal, -ray_direction, specular, scene);
+      const auto local_color = local_radiance(material.get<"color">(), intensity);
+
+      const auto reflectiveness = material.get<"reflective">();
+      const double reflected_throughput = throughput * reflectiveness;
+
+      if (ray.template get<"depth">() <= 0 || reflectiveness <= 0.0 ||
+          reflected_throughput < settings.get<"min_contribution">() ||
+          stack_size == stack.size()) {
+        accumulate(local_color, throughput);
+      } else {
+        accumulate(local_color, throughput * (1.0 - reflectiveness));
+        stack[stack_size++] = Ray{spawn, reflect_ray(-ray_direction, normal),
+                                  ray.template get<"depth">() - 1, reflected_throughput};
+      }
+    }
+
+    if (stack_size == 0) { break; }
+
+    ray = stack[--stack_size];
+    hit = closest_intersection(ray.template get<"origin">(), ray.template get<"direction">(),
+                               static_cast<Scalar>(0.001), static_cast<Scalar>(basically_infinity),
+                               scene);
+  }
+
+  return RGB64F{red, green, blue};
+}
+
+/**
+ * @brief Trace a ray with the iterative tracer and convert the result to 8 bit once
+ */
+template <typename Precision = ExactMath, typename SceneType>
+constexpr Color3 trace_ray_iterative(const Vec3<scene_scalar_t<SceneType>>& origin,
+                                     const Vec3<scene_scalar_t<SceneType>>& direction,
+                                     std::type_identity_t<scene_scalar_t<SceneType>> t_min,
+                                     std::type_identity_t<scene_scalar_t<SceneType>> t_max,
+                                     const TraceSettings& settings, const SceneType& scene) {
+  return to_color3(trace_radiance<Precision>(
+      origin, direction, closest_intersection(origin, direction, t_min, t_max, scene), settings,
+      scene));
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_TRACER_HPP
@@ -0,0 +1,251 @@
+/**
+ * @brief Wavefront tracing: whole queues of rays advanced one stage at a time
+ * @author Matthew Guidry (github: mguid65)
+ * @date 10/17/26
+ */
+
+#ifndef CGFS_WAVEFRONT_HPP
+#define CGFS_WAVEFRONT_HPP
+
+#include "CGFS/ThirdParty/Named/NamedTuple.hpp"
+
+#include "CGFS/Camera.hpp"
+#include "CGFS/Color.hpp"
+#include "CGFS/Common.hpp"
+#include "CGFS/Lighting/Light.hpp"
+#include "CGFS/Lighting/PreparedLights.hpp"
+#include "CGFS/Math.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/Shading.hpp"
+#include "CGFS/Tracing/ShadowCache.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace cgfs {
+
+/**
+ * @brief A ray in a wavefront queue
+ *
+ * path indexes the radiance entry the ray contributes to, throughput is the weight of that
+ * contribution.
+ */
+using WavefrontRay = mguid::NamedTuple<mguid::NamedType<"origin", Origin>,
+                                       mguid::NamedType<"direction", Vec3d>,
+                                       mguid::NamedType<"t_min", double>,
+                                       mguid::NamedType<"path", uint32_t>,
+                                       mguid::NamedType<"depth", int>,
+                                       mguid::NamedType<"throughput", double>>;
+
+/**
+ * @brief One light's contribution to one hit, pending its shadow test
+ *
+ * Ambient lights and lights that add nothing skip the test and are visible from the start.
+ */
+using LightSample = mguid::NamedTuple<mguid::NamedType<"ray", uint32_t>,
+                                      mguid::NamedType<"light", uint32_t>,
+                                      mguid::NamedType<"direction", Vec3d>,
+                                      mguid::NamedType<"t_max", double>,
+                                      mguid::NamedType<"intensity", double>,
+                                      mguid::NamedType<"needs_test", bool>,
+                                      mguid::NamedType<"visible", bool>>;
+
+namespace detail {
+
+/**
+ * @brief Sign bits of a direction, so rays heading into the same octant end up adjacent
+ */
+constexpr uint32_t direction_octant(const Vec3d& direction) {
+  return (direction.get<"x">() < 0.0 ? 1U : 0U) | (direction.get<"y">() < 0.0 ? 2U : 0U) |
+         (direction.get<"z">() < 0.0 ? 4U : 0U);
+}
+
+}  // namespace detail
+
+/**
+ * @brief Trace a queue of rays in stages: intersect, shade, shadow test, resolve
+ *
+ * Each stage runs over the whole queue before the next starts, instead of one pixel running
+ * every stage in turn. The resolve stage compacts surviving reflection rays into the next
+ * queue, and the loop repeats until no ray is left. With sort_queues the shadow tests run
+ * grouped by light and the reflection queue is ordered by direction octant, which keeps
+ * neighbouring queries coherent.
+ *
+ * Every path accumulates its bounces in the same order and with the same arithmetic as
+ * trace_radiance, so the result does not depend on queue order.
+ *
+ * @param rays primary rays, consumed by the call
+ * @param settings termination controls
+ * @param scene scene to trace
+ * @param sort_queues whether to sort the shadow and reflection queues
+ * @param radiance per path output, accumulated into
+ */
+template <typename SceneType>
+void trace_wavefront(std::vector<WavefrontRay>& rays, const TraceSettings& settings,
+                     const SceneType& scene, bool sort_queues, std::span<RGB64F> radiance) {
+  const auto& lights = scene.template get<"lights">();
+
+  std::vector<ClosestIntersectionResult> hits;
+  std::vector<Vec3d> points;
+  std::vector<Vec3d> normals;
+  std::vector<LightSample> samples;
+  std::vector<uint32_t> sample_begin;
+  std::vector<uint32_t> shadow_order;
+  std::vector<WavefrontRay> next_rays;
+
+  const auto accumulate = [&](uint32_t path, const auto& color, double weight) {
+    auto& target = radiance[path];
+    target.get<"r">() += weight * static_cast<double>(color.template get<"r">());
+    target.get<"g">() += weight * static_cast<double>(color.template get<"g">());
+    target.get<"b">() += weight * static_cast<double>(color.template get<"b">());
+  };
+
+  while (!rays.empty()) {
+    const size_t count = rays.size();
+
+    // Intersect
+    hits.resize(count);
+    for (size_t i{0}; i < count; ++i) {
+      const auto& ray = rays[i];
+      hits[i] = closest_intersection(ray.get<"origin">(), ray.get<"direction">(),
+                                     ray.get<"t_min">(), basically_infinity, scene);
+    }
+
+    // Shade: surface frames and one light sample per light and hit
+    points.resize(count);
+    normals.resize(count);
+    samples.clear();
+    sample_begin.resize(count + 1);
+    for (size_t i{0}; i < count; ++i) {
+      sample_begin[i] = static_cast<uint32_t>(samples.size());
+
+      if (!is_hit(hits[i])) { continue; }
+
+      const auto& direction = rays[i].get<"direction">();
+      points[i] = rays[i].get<"origin">() + (hits[i].get<"closest_t">() * direction);
+      normals[i] = hit_normal(hits[i], points[i]);
+
+      const double specular = hit_material(hits[i]).get<"specular">();
+      const auto ray_index = static_cast<uint32_t>(i);
+
+      const auto emit = [&](uint32_t light_index, const Vec3d& light_direction, double t_max,
+                            double intensity) {
+        const bool needs_test = t_max != 0.0 && intensity != 0.0;
+        samples.emplace_back(ray_index, light_index, light_direction, t_max, intensity,
+                             needs_test, !needs_test);
+      };
+
+      if constexpr (std::is_same_v<SceneType, CompiledScene>) {
+        // Ambient first, then one sample per light, as compute_lighting adds them
+        const PreparedLights& prepared = scene.template get<"prepared_lights">();
+        emit(0, Vec3d{}, 0.0, prepared.get<"ambient">());
+        for_each_light_sample(points[i], normals[i], -direction, specular, prepared,
+                              [&](uint32_t light_index, const Vec3d& light_direction,
+                                  double t_max, double intensity) {
+                                emit(light_index + 1, light_direction, t_max, intensity);
+                              });
+        continue;
+      }
+
+      for (uint32_t light_index{0}; light_index < lights.size(); ++light_index) {
+        lights[light_index].visit(
+            [&](const AmbientLightProperties& ambient_light) {
+              emit(light_index, Vec3d{}, 0.0, ambient_light.get<"intensity">());
+            },
+            [&](const PointLightProperties& point_light) {
+              const auto light_direction = point_light.get<"position">() - points[i];
+              emit(light_index, light_direction, 1.0,
+                   diffuse_specular_intensity(normals[i], -direction, specular,
+                                              point_light.get<"intensity">(), light_direction));
+            },
+            [&](const DirectionalLightProperties& directional_light) {
+              const auto light_direction = directional_light.get<"direction">();
+              emit(light_index, light_direction, basically_infinity,
+                   diffuse_specular_intensity(normals[i], -direction, specular,
+                                              directional_light.get<"intensity">(),
+                                              light_direction));
+            });
+      }
+    }
+    sample_begin[count] = static_cast<uint32_t>(samples.size());
+
+    // Shadow test, only for samples that could change the result
+    shadow_order.clear();
+    for (uint32_t s{0}; s < samples.size(); ++s) {
+      if (samples[s].get<"needs_test">()) { shadow_order.push_back(s); }
+    }
+    if (sort_queues) {
+      std::stable_sort(shadow_order.begin(), shadow_order.end(), [&](uint32_t lhs, uint32_t rhs) {
+        return samples[lhs].get<"light">() < samples[rhs].get<"light">();
+      });
+    }
+    for (const auto s : shadow_order) {
+      auto& sample = samples[s];
+      const auto& point = points[sample.get<"ray">()];
+      if constexpr (std::is_same_v<SceneType, CompiledScene>) {
+        // Sample lights count the ambient term as 0, the cache is keyed like compute_lighting
+        sample.get<"visible">() =
+            settings.get<"shadow_cache">()
+                ? !occluded(point, sample.get<"direction">(), 0.001, sample.get<"t_max">(),
+                            scene, thread_shadow_cache(), sample.get<"light">() - 1)
+                : !occluded(point, sample.get<"direction">(), 0.001, sample.get<"t_max">(),
+                            scene);
+      } else {
+        sample.get<"visible">() =
+            !occluded(point, sample.get<"direction">(), 0.001, sample.get<"t_max">(), scene);
+      }
+    }
+
+    // Resolve: add local colors in light order and compact the reflection rays
+    next_rays.clear();
+    for (size_t i{0}; i < count; ++i) {
+      const auto& ray = rays[i];
+      const auto path = ray.get<"path">();
+      const double throughput = ray.get<"throughput">();
+
+      if (!is_hit(hits[i])) {
+        accumulate(path, scene.template get<"background_color">(), throughput);
+        continue;
+      }
+
+      double intensity = 0.0;
+      for (uint32_t s{sample_begin[i]}; s < sample_begin[i + 1]; ++s) {
+        intensity += samples[s].get<"visible">() ? samples[s].get<"intensity">() : 0.0;
+      }
+
+      const auto& material = hit_material(hits[i]);
+      const auto local_color = local_radiance(material.get<"color">(), intensity);
+      const auto reflectiveness = material.get<"reflective">();
+      const double reflected_throughput = throughput * reflectiveness;
+
+      if (ray.get<"depth">() <= 0 || reflectiveness <= 0.0 ||
+          reflected_throughput < settings.get<"min_contribution">()) {
+        accumulate(path, local_color, throughput);
+        continue;
+      }
+
+      accumulate(path, local_color, throughput * (1.0 - reflectiveness));
+      next_rays.emplace_back(points[i], reflect_ray(-ray.get<"direction">(), normals[i]), 0.001,
+                             path, ray.get<"depth">() - 1, reflected_throughput);
+    }
+
+    if (sort_queues) {
+      std::stable_sort(next_rays.begin(), next_rays.end(),
+                       [](const WavefrontRay& lhs, const WavefrontRay& rhs) {
+                         return detail::direction_octant(lhs.get<"direction">()) <
+                                detail::direction_octant(rhs.get<"direction">());
+                       });
+    }
+
+    rays.swap(next_rays);
+  }
+}
+
+}  // namespace cgfs
+
+#endif  // CGFS_WAVEFRONT_HPP
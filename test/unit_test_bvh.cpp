@@ -0,0 +1,346 @@
+#include "CGFS/Accel/BVH.hpp"
+#include "CGFS/Accel/SphereSoA.hpp"
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/CpuFeatures.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/Intersection.hpp"
+#include "CGFS/Tracing/RayPacket.hpp"
+#include "CGFS/Tracing/ShadowCache.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+namespace {
+constexpr size_t num_spheres = 300;
+
+std::unique_ptr<cgfs::Scene<num_spheres, 1>> make_random_scene() {
+  std::mt19937 rng{1234};
+  std::uniform_real_distribution<double> position{-20.0, 20.0};
+  std::uniform_real_distribution<double> radius{0.1, 1.5};
+  std::uniform_int_distribution<int> shade{0, 3};
+
+  std::array<cgfs::Sphere, num_spheres> spheres;
+  for (auto& sphere : spheres) {
+    const auto red = static_cast<uint8_t>(85 * shade(rng));
+    sphere = cgfs::Sphere{cgfs::Vec3d{position(rng), position(rng), position(rng)}, radius(rng),
+                          cgfs::MaterialProperties{cgfs::Color3{red, 0, 0}, 10.0, 0.0}};
+  }
+
+  return std::make_unique<cgfs::Scene<num_spheres, 1>>(
+      spheres, std::array{cgfs::Light{cgfs::AmbientLightProperties{1.0}}},
+      cgfs::Color3{0, 0, 0});
+}
+}  // namespace
+
+TEST_CASE("BVH") {
+  SECTION("Every primitive lands in exactly one leaf") {
+    std::vector<cgfs::AABB> bounds;
+    for (int i = 0; i < 100; ++i) {
+      const auto offset = static_cast<double>(i % 10);
+      bounds.emplace_back(cgfs::Vec3d{offset, offset, offset},
+                          cgfs::Vec3d{offset + 1.0, offset + 1.0, offset + 1.0});
+    }
+
+    const cgfs::BVH bvh{bounds};
+    std::vector<int> seen(bounds.size(), 0);
+    for (const auto& node : bvh.nodes()) {
+      for (uint32_t i{0}; i < node.get<"count">(); ++i) {
+        ++seen[bvh.primitive_order()[node.get<"offset">() + i]];
+      }
+    }
+    for (const auto count : seen) { REQUIRE(count == 1); }
+  }
+
+  SECTION("Matches the linear closest intersection") {
+    const auto scene = make_random_scene();
+    const auto compiled = cgfs::compile_scene(*scene);
+
+    std::mt19937 rng{99};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+
+    for (int i = 0; i < 2000; ++i) {
+      const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      const cgfs::Vec3d direction{component(rng), component(rng), component(rng)};
+
+      const auto linear =
+          cgfs::closest_intersection(origin, direction, 0.001, cgfs::basically_infinity, *scene);
+      const auto bvh =
+          cgfs::closest_intersection(origin, direction, 0.001, cgfs::basically_infinity, compiled);
+
+      REQUIRE(cgfs::is_hit(linear) == cgfs::is_hit(bvh));
+      if (cgfs::is_hit(linear)) {
+        const double linear_t = linear.get<"closest_t">();
+        REQUIRE(bvh.get<"closest_t">() == Catch::Approx(linear_t));
+        REQUIRE(cgfs::hit_material(bvh) == cgfs::hit_material(linear));
+
+        const auto point = origin + (linear_t * direction);
+        const auto normal_error = cgfs::hit_normal(bvh, point) - cgfs::hit_normal(linear, point);
+        REQUIRE(cgfs::length(normal_error) < 1e-9);
+      }
+    }
+  }
+}
+
+TEST_CASE("CompiledScene") {
+  SECTION("Materials are deduplicated into a table indexed per sphere") {
+    const auto scene = make_random_scene();
+    auto compiled = cgfs::compile_scene(*scene);
+    const auto& objects = scene->get<"objects">();
+    const auto& order = compiled.get<"bvh">().primitive_order();
+
+    REQUIRE(compiled.get<"materials">().size() == 4);
+    REQUIRE(compiled.get<"sphere_materials">().size() == num_spheres);
+    for (size_t slot{0}; slot < num_spheres; ++slot) {
+      REQUIRE(compiled.get<"materials">()[compiled.get<"sphere_materials">()[slot]] ==
+              objects[order[slot]].get<"material">());
+    }
+
+    auto edited = objects[17];
+    edited.get<"material">().get<"specular">() = 500.0;
+    REQUIRE(cgfs::update_sphere(compiled, 17, edited) == objects[17]);
+    REQUIRE(compiled.get<"materials">().size() == 5);
+    REQUIRE(cgfs::update_sphere(compiled, 17, objects[17]) == edited);
+    REQUIRE(compiled.get<"materials">().size() == 5);
+  }
+}
+
+TEST_CASE("Occlusion") {
+  SECTION("Any-hit query agrees with the closest hit query") {
+    const auto scene = make_random_scene();
+    const auto compiled = cgfs::compile_scene(*scene);
+
+    std::mt19937 rng{2024};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+    std::uniform_real_distribution<double> reach{0.5, 60.0};
+
+    for (int i = 0; i < 2000; ++i) {
+      const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      const cgfs::Vec3d direction{component(rng), component(rng), component(rng)};
+      const double t_max = i % 2 == 0 ? cgfs::basically_infinity : reach(rng);
+
+      const bool blocked =
+          cgfs::is_hit(cgfs::closest_intersection(origin, direction, 0.001, t_max, *scene));
+
+      REQUIRE(cgfs::occluded(origin, direction, 0.001, t_max, *scene) == blocked);
+      REQUIRE(cgfs::occluded(origin, direction, 0.001, t_max, compiled) == blocked);
+    }
+  }
+
+  SECTION("The last occluder cache never changes an answer") {
+    const auto scene = make_random_scene();
+    const auto compiled = cgfs::compile_scene(*scene);
+    const auto& spheres = compiled.get<"spheres">();
+
+    std::mt19937 rng{77};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+    std::uniform_int_distribution<uint32_t> light{0, 3};
+    std::uniform_int_distribution<uint32_t> slot{0, num_spheres + 10};
+
+    cgfs::ShadowCache cache;
+    for (int i = 0; i < 2000; ++i) {
+      const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      // Rays from nearby points towards a few fixed lights, like neighbouring shade points
+      const auto light_index = light(rng);
+      const cgfs::Vec3d target{10.0 * light_index, 25.0, 5.0};
+      const auto direction = target - origin;
+      // Every so often plant a stale or out of range entry
+      if (i % 7 == 0) { cache.remember(light_index, slot(rng)); }
+
+      const bool blocked = cgfs::occluded(origin, direction, 0.001, 1.0, compiled);
+      REQUIRE(cgfs::occluded(origin, direction, 0.001, 1.0, compiled, cache, light_index) ==
+              blocked);
+
+      const auto remembered = cache.blocker(light_index);
+      if (blocked && remembered < spheres.size()) {
+        REQUIRE(cgfs::any_sphere_hit(spheres, origin, direction, 0.001, 1.0, remembered,
+                                     remembered + 1));
+      }
+    }
+  }
+}
+
+TEST_CASE("SphereSoA") {
+  SECTION("SIMD kernel matches the scalar kernel on every sub-range") {
+    const auto scene = make_random_scene();
+    const auto& objects = scene->get<"objects">();
+    const cgfs::SphereSoA spheres{objects};
+
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+    std::uniform_int_distribution<uint32_t> index{0, num_spheres};
+
+    for (int i = 0; i < 2000; ++i) {
+      const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      const cgfs::Vec3d direction{component(rng), component(rng), component(rng)};
+      auto first = index(rng);
+      auto last = index(rng);
+      if (first > last) { std::swap(first, last); }
+
+      const auto simd = cgfs::intersect_spheres(spheres, origin, direction, 0.001,
+                                                cgfs::basically_infinity, first, last);
+      const auto scalar = cgfs::detail::intersect_spheres_scalar(
+          spheres, origin, direction, 0.001, cgfs::basically_infinity, first, last);
+
+      REQUIRE(simd.get<"index">() == scalar.get<"index">());
+      REQUIRE(simd.get<"t">() == Catch::Approx(scalar.get<"t">()));
+    }
+  }
+
+  SECTION("Float kernels match the float scalar kernel and the double hits") {
+    const auto scene = make_random_scene();
+    const auto& objects = scene->get<"objects">();
+    const cgfs::SphereSoA spheres{objects};
+    const cgfs::SphereSoAF spheres_f{objects};
+
+    std::mt19937 rng{8};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+    std::uniform_int_distribution<uint32_t> index{0, num_spheres};
+
+    int index_mismatches = 0;
+    for (int i = 0; i < 2000; ++i) {
+      const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      const cgfs::Vec3d direction{component(rng), component(rng), component(rng)};
+      const auto origin_f = cgfs::vec3_cast<float>(origin);
+      const auto direction_f = cgfs::vec3_cast<float>(direction);
+      auto first = index(rng);
+      auto last = index(rng);
+      if (first > last) { std::swap(first, last); }
+
+      const auto simd = cgfs::intersect_spheres(spheres_f, origin_f, direction_f, 0.001F, 1e12F,
+                                                first, last);
+      const auto scalar = cgfs::detail::intersect_spheres_scalar(
+          spheres_f, origin_f, direction_f, 0.001F, 1e12F, first, last);
+      const auto exact = cgfs::intersect_spheres(spheres, origin, direction, 0.001,
+                                                 cgfs::basically_infinity, first, last);
+
+      REQUIRE(simd.get<"index">() == scalar.get<"index">());
+      REQUIRE(simd.get<"t">() == Catch::Approx(scalar.get<"t">()));
+      if (simd.get<"index">() != exact.get<"index">()) {
+        ++index_mismatches;
+        continue;
+      }
+      if (exact.get<"index">() != cgfs::no_sphere) {
+        REQUIRE(simd.get<"t">() == Catch::Approx(exact.get<"t">()).epsilon(1e-4));
+      }
+    }
+
+    // Only rays that just graze a sphere may see it differently in float
+    REQUIRE(index_mismatches < 10);
+  }
+
+  SECTION("Every SIMD level this CPU supports finds the same hits") {
+    const auto scene = make_random_scene();
+    const auto& objects = scene->get<"objects">();
+    const cgfs::SphereSoA spheres{objects};
+    const cgfs::SphereSoAF spheres_f{objects};
+    const auto supported = cgfs::supported_simd_level();
+
+    for (const auto level : {cgfs::SimdLevel::scalar, cgfs::SimdLevel::sse2,
+                             cgfs::SimdLevel::avx2, cgfs::SimdLevel::avx512}) {
+      if (level > supported) {
+        REQUIRE_THROWS_AS(cgfs::force_simd_level(level), std::invalid_argument);
+        continue;
+      }
+      cgfs::force_simd_level(level);
+      REQUIRE(cgfs::simd_level() == level);
+
+      std::mt19937 rng{9};
+      std::uniform_real_distribution<double> component{-1.0, 1.0};
+      std::uniform_int_distribution<uint32_t> index{0, num_spheres};
+
+      for (int i = 0; i < 500; ++i) {
+        const cgfs::Origin origin{component(rng) * 30.0, component(rng) * 30.0,
+                                  component(rng) * 30.0};
+        const cgfs::Vec3d direction{component(rng), component(rng), component(rng)};
+        const auto origin_f = cgfs::vec3_cast<float>(origin);
+        const auto direction_f = cgfs::vec3_cast<float>(direction);
+        auto first = index(rng);
+        auto last = index(rng);
+        if (first > last) { std::swap(first, last); }
+
+        const auto simd = cgfs::intersect_spheres(spheres, origin, direction, 0.001,
+                                                  cgfs::basically_infinity, first, last);
+        const auto scalar = cgfs::detail::intersect_spheres_scalar(
+            spheres, origin, direction, 0.001, cgfs::basically_infinity, first, last);
+        REQUIRE(simd.get<"index">() == scalar.get<"index">());
+        REQUIRE(simd.get<"t">() == Catch::Approx(scalar.get<"t">()));
+
+        const auto simd_f = cgfs::intersect_spheres(spheres_f, origin_f, direction_f, 0.001F,
+                                                    1e12F, first, last);
+        const auto scalar_f = cgfs::detail::intersect_spheres_scalar(
+            spheres_f, origin_f, direction_f, 0.001F, 1e12F, first, last);
+        REQUIRE(simd_f.get<"index">() == scalar_f.get<"index">());
+        REQUIRE(simd_f.get<"t">() == Catch::Approx(scalar_f.get<"t">()));
+      }
+
+      // Calls go through the kernels bound for the level, not a per-call switch
+      REQUIRE(cgfs::detail::bound_intersect_spheres<double>.load() ==
+              cgfs::detail::intersect_spheres_kernel<double>(level));
+      REQUIRE(cgfs::detail::bound_intersect_spheres<float>.load() ==
+              cgfs::detail::intersect_spheres_kernel<float>(level));
+    }
+
+    cgfs::reset_simd_level();
+    REQUIRE(cgfs::simd_level() == supported);
+    REQUIRE(cgfs::parse_simd_level("avx2") == cgfs::SimdLevel::avx2);
+    REQUIRE_FALSE(cgfs::parse_simd_level("sse4.2").has_value());
+
+    std::ostringstream warnings;
+    REQUIRE(cgfs::detail::requested_simd_level("scalar", supported, warnings) ==
+            cgfs::SimdLevel::scalar);
+    REQUIRE(warnings.str().empty());
+    REQUIRE(cgfs::detail::requested_simd_level("sse4.2", supported, warnings) == supported);
+    REQUIRE(warnings.str().find("CGFS_SIMD=sse4.2") != std::string::npos);
+  }
+}
+
+TEST_CASE("RayPacket") {
+  SECTION("Packet hits match single ray hits, masked lanes stay empty") {
+    const auto scene = make_random_scene();
+    const auto compiled = cgfs::compile_scene(*scene);
+
+    std::mt19937 rng{42};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+
+    for (int i = 0; i < 200; ++i) {
+      cgfs::RayPacket<16> packet;
+      packet.origin =
+          cgfs::Origin{component(rng) * 30.0, component(rng) * 30.0, component(rng) * 30.0};
+      const cgfs::Vec3d base{component(rng), component(rng), component(rng)};
+      for (size_t lane{0}; lane < packet.lanes; ++lane) {
+        if (lane % 5 == 4) { continue; }
+        packet.set_direction(lane, base + cgfs::Vec3d{component(rng) * 0.1, component(rng) * 0.1,
+                                                      component(rng) * 0.1});
+      }
+
+      const auto linear =
+          cgfs::closest_intersection(packet, 0.001, cgfs::basically_infinity, *scene);
+      const auto bvh =
+          cgfs::closest_intersection(packet, 0.001, cgfs::basically_infinity, compiled);
+
+      for (size_t lane{0}; lane < packet.lanes; ++lane) {
+        if (!packet.active[lane]) {
+          REQUIRE(!cgfs::is_hit(bvh[lane]));
+          continue;
+        }
+
+        const auto ray = cgfs::closest_intersection(packet.origin, packet.direction(lane), 0.001,
+                                                    cgfs::basically_infinity, compiled);
+
+        REQUIRE(cgfs::is_hit(bvh[lane]) == cgfs::is_hit(ray));
+        REQUIRE(cgfs::is_hit(linear[lane]) == cgfs::is_hit(ray));
+        if (cgfs::is_hit(ray)) {
+          REQUIRE(bvh[lane].get<"closest_t">() == Catch::Approx(ray.get<"closest_t">()));
+          REQUIRE(linear[lane].get<"closest_t">() == Catch::Approx(ray.get<"closest_t">()));
+          REQUIRE(cgfs::hit_object(bvh[lane]) == cgfs::hit_object(ray));
+        }
+      }
+    }
+  }
+}
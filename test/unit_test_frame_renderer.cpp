@@ -0,0 +1,346 @@
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Precision.hpp"
+#include "CGFS/Render/AdaptiveSampler.hpp"
+#include "CGFS/Render/FrameRenderer.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+struct RecordingCanvas : cgfs::BBoxi32 {
+  RecordingCanvas(int32_t width, int32_t height)
+      : cgfs::BBoxi32{-width / 2, width / 2, -height / 2, height / 2},
+        m_width{width},
+        hits(static_cast<size_t>(width * height)),
+        reds(static_cast<size_t>(width * height), 0) {}
+
+  using cgfs::BBoxi32::get;
+
+  void put_pixel(int32_t x, int32_t y, cgfs::Color3 color) {
+    const auto index = static_cast<size_t>((y - get<"bottom">()) * m_width + (x - get<"left">()));
+    hits[index].fetch_add(1);
+    reds[index] = color.get<"r">();
+  }
+
+  int32_t m_width;
+  std::vector<std::atomic<int>> hits;
+  std::vector<uint8_t> reds;
+};
+
+// Just enough of a canvas to generate primary rays for, without opening a window
+struct HeadlessCanvas : cgfs::DimensionsU32, cgfs::BBoxi32 {
+  HeadlessCanvas(int32_t width, int32_t height)
+      : cgfs::DimensionsU32{static_cast<uint32_t>(width), static_cast<uint32_t>(height)},
+        cgfs::BBoxi32{-width / 2, width / 2, -height / 2, height / 2} {}
+
+  using cgfs::BBoxi32::get;
+  using cgfs::DimensionsU32::get;
+
+  void put_pixel(int32_t, int32_t, cgfs::Color3) {}
+};
+}  // namespace
+
+TEST_CASE("FrameRenderer") {
+  SECTION("Tiles cover the bounds exactly once") {
+    const cgfs::BBoxi32 bounds{-50, 51, -20, 33};
+    const auto tiles = cgfs::split_into_tiles(bounds, 16);
+
+    REQUIRE(tiles.size() == 7 * 4);
+
+    std::vector<int> coverage(101 * 53, 0);
+    for (const auto& tile : tiles) {
+      REQUIRE(tile.get<"right">() - tile.get<"left">() <= 16);
+      REQUIRE(tile.get<"top">() - tile.get<"bottom">() <= 16);
+      for (auto y{tile.get<"bottom">()}; y < tile.get<"top">(); ++y) {
+        for (auto x{tile.get<"left">()}; x < tile.get<"right">(); ++x) {
+          ++coverage[static_cast<size_t>((y + 20) * 101 + (x + 50))];
+        }
+      }
+    }
+    for (const auto count : coverage) { REQUIRE(count == 1); }
+
+    REQUIRE(cgfs::split_into_tiles(cgfs::BBoxi32{0, 0, 0, 10}).empty());
+  }
+
+  SECTION("Every pixel is shaded once") {
+    cgfs::ThreadPool pool{4};
+    RecordingCanvas canvas{66, 44};
+
+    cgfs::render_frame(
+        pool, canvas, [](int32_t, int32_t) { return cgfs::Color3{7, 0, 0}; }, 8);
+
+    for (const auto& hit : canvas.hits) { REQUIRE(hit.load() == 1); }
+    for (const auto red : canvas.reds) { REQUIRE(red == 7); }
+  }
+
+  SECTION("Progressive passes shade every pixel once and end at full resolution") {
+    cgfs::ThreadPool pool{4};
+    RecordingCanvas canvas{66, 44};
+    std::vector<std::atomic<int>> shaded(canvas.hits.size());
+    int presented = 0;
+
+    const auto red_of = [](int32_t x, int32_t y) {
+      return static_cast<uint8_t>((x * 7 + y * 13) & 0xff);
+    };
+
+    cgfs::render_progressive(
+        pool, canvas,
+        [&](int32_t x, int32_t y) {
+          shaded[static_cast<size_t>((y + 22) * 66 + (x + 33))].fetch_add(1);
+          return cgfs::Color3{red_of(x, y), 0, 0};
+        },
+        [&]() { ++presented; }, cgfs::default_progressive_passes, 16);
+
+    REQUIRE(presented == static_cast<int>(cgfs::default_progressive_passes.size()));
+    for (const auto& count : shaded) { REQUIRE(count.load() == 1); }
+    for (int32_t y{-22}; y < 22; ++y) {
+      for (int32_t x{-33}; x < 33; ++x) {
+        REQUIRE(canvas.reds[static_cast<size_t>((y + 22) * 66 + (x + 33))] == red_of(x, y));
+      }
+    }
+
+    const std::array<int32_t, 2> uneven{3, 2};
+    REQUIRE_THROWS_AS(cgfs::render_progressive(
+                          pool, canvas, [](int32_t, int32_t) { return cgfs::Color3{}; }, [] {},
+                          uneven),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("CameraRayGenerator") {
+  const HeadlessCanvas canvas{64, 48};
+  const cgfs::Viewport viewport{1.0, 0.75};
+  const double c = std::cos(0.3);
+  const double s = std::sin(0.3);
+  const cgfs::Camera camera{cgfs::Vec3d{1.0, 2.0, -3.0},
+                            cgfs::Mat3d{{{c, 0.0, s}, {0.0, 1.0, 0.0}, {-s, 0.0, c}}},
+                            cgfs::ProjectionPlane{1.0}};
+  const cgfs::CameraRayGenerator rays{viewport, canvas, camera};
+
+  SECTION("Directions match the per pixel transform up to rounding") {
+    for (int32_t y{-24}; y < 24; ++y) {
+      for (int32_t x{-32}; x < 32; ++x) {
+        const auto expected = camera.get<"rotation">() *
+                              cgfs::canvas_to_viewport(cgfs::Vec2i32{x, y}, viewport, canvas,
+                                                       camera);
+        REQUIRE(cgfs::length(rays.direction(x, y) - expected) < 1e-12);
+      }
+    }
+
+    const auto fractional = camera.get<"rotation">() *
+                            cgfs::canvas_to_viewport(cgfs::Vec2d{0.25, -3.5}, viewport, canvas,
+                                                     camera);
+    REQUIRE(cgfs::length(rays.direction(0.25, -3.5) - fractional) < 1e-12);
+  }
+
+  SECTION("Row batches match single directions and reject ragged streams") {
+    std::vector<double> xs(40);
+    std::vector<double> ys(40);
+    std::vector<double> zs(40);
+    rays.fill_row(-20, 7, xs, ys, zs);
+    for (size_t i{0}; i < xs.size(); ++i) {
+      const auto direction = rays.direction(-20 + static_cast<int32_t>(i), 7);
+      REQUIRE(cgfs::length(cgfs::Vec3d{xs[i], ys[i], zs[i]} - direction) < 1e-12);
+    }
+
+    REQUIRE_THROWS_AS(rays.fill_row(0, 0, xs, ys, std::span{zs}.first(3)),
+                      std::invalid_argument);
+  }
+
+  SECTION("The float generator follows the double one") {
+    const cgfs::CameraRayGeneratorF rays_f{viewport, canvas, cgfs::camera_cast<float>(camera)};
+    for (int32_t y{-24}; y < 24; y += 5) {
+      for (int32_t x{-32}; x < 32; x += 3) {
+        const auto error = cgfs::vec3_cast<double>(rays_f.direction(x, y)) - rays.direction(x, y);
+        REQUIRE(cgfs::length(error) < 1e-6);
+      }
+    }
+  }
+}
+
+TEST_CASE("Precision") {
+  cgfs::ThreadPool pool{4};
+  cgfs::DynamicScene scene{cgfs::Color3{150, 175, 255}};
+  scene.add_object(cgfs::Sphere{cgfs::Vec3d{0.0, -1.0, 3.0}, 1.0,
+                                cgfs::MaterialProperties{cgfs::Color3{255, 0, 0}, 500.0, 0.3}});
+  scene.add_object(cgfs::Sphere{cgfs::Vec3d{2.0, 0.0, 4.0}, 1.0,
+                                cgfs::MaterialProperties{cgfs::Color3{0, 0, 255}, 10.0, 0.3}});
+  scene.add_shape(cgfs::Plane{cgfs::Vec3d{0.0, 1.0, 0.0}, -1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{100, 100, 100}, 1.0, 0.1}});
+  scene.add_light(cgfs::Light{cgfs::AmbientLightProperties{0.2}});
+  scene.add_light(cgfs::Light{cgfs::PointLightProperties{0.6, cgfs::Vec3d{2.0, 1.0, 0.0}}});
+  scene.add_light(
+      cgfs::Light{cgfs::DirectionalLightProperties{0.2, cgfs::Vec3d{1.0, 4.0, 4.0}}});
+  const auto compiled = cgfs::compile_scene(cgfs::DynamicScene{scene});
+
+  HeadlessCanvas canvas{96, 96};
+  const cgfs::Viewport viewport{cgfs::DimensionsF64{1.0, 1.0}};
+  const cgfs::Camera camera{cgfs::Origin{0.0, 0.0, 0.0},
+                            cgfs::Mat3d{std::array{1.0, 0.0, 0.0}, std::array{0.0, 1.0, 0.0},
+                                        std::array{0.0, 0.0, 1.0}},
+                            cgfs::ProjectionPlane{1.0}};
+  const cgfs::TraceSettings settings{3, cgfs::default_min_contribution, false};
+
+  SECTION("The exact policy compares equal to itself") {
+    const auto error = cgfs::compare_precision<cgfs::ExactMath>(pool, canvas, viewport, camera,
+                                                                compiled, settings);
+    REQUIRE(error.get<"max">() == 0);
+    REQUIRE(error.get<"mean">() == 0.0);
+  }
+
+  SECTION("The fast policy stays within one 8 bit step") {
+    const auto error = cgfs::compare_precision<cgfs::FastMath>(pool, canvas, viewport, camera,
+                                                               compiled, settings);
+    REQUIRE(error.get<"max">() <= 1);
+    REQUIRE(error.get<"mean">() < 0.01);
+  }
+
+  SECTION("Compiled sphere normals go through the policy's normalize") {
+    std::mt19937 rng{9};
+    std::uniform_real_distribution<double> component{-0.5, 0.5};
+
+    int sphere_hits = 0;
+    int differing = 0;
+    for (int i = 0; i < 500; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      const auto hit = cgfs::closest_intersection(cgfs::Origin{0.0, 0.0, 0.0}, direction, 1.0,
+                                                  cgfs::basically_infinity, compiled);
+      if (!cgfs::is_hit(hit) || cgfs::hit_material(hit).get<"specular">() == 1.0) { continue; }
+      ++sphere_hits;
+
+      const auto point = hit.get<"closest_t">() * direction;
+      const auto exact = cgfs::hit_normal<cgfs::ExactMath>(hit, point);
+      const auto fast = cgfs::hit_normal<cgfs::FastMath>(hit, point);
+      REQUIRE(cgfs::length(fast - exact) < 5e-6);
+      differing += fast != exact;
+    }
+
+    REQUIRE(sphere_hits > 0);
+    REQUIRE(differing > 0);
+  }
+
+  SECTION("Fast helpers hold their documented bounds") {
+    std::mt19937 rng{8};
+    std::uniform_real_distribution<double> component{-100.0, 100.0};
+    std::uniform_real_distribution<double> base{1e-6, 1.0};
+    std::uniform_real_distribution<double> exponent{0.0, 1000.0};
+
+    for (int i = 0; i < 10000; ++i) {
+      const cgfs::Vec3d vec{component(rng), component(rng), component(rng)};
+      REQUIRE(std::abs(cgfs::FastMath::length(vec) / cgfs::length(vec) - 1.0) < 5e-6);
+
+      const double b = base(rng);
+      const double e = exponent(rng);
+      const double exact = std::pow(b, e);
+      if (exact < 1e-300) { continue; }
+      REQUIRE(std::abs(cgfs::FastMath::pow(b, e) / exact - 1.0) < 1e-8 * (1.0 + e));
+    }
+  }
+}
+
+TEST_CASE("AdaptiveSampler") {
+  // A vertical edge between two flat regions, a quarter of the way into pixel column 4
+  const auto sample_edge = [](double x, double) {
+    const bool right = x >= 4.25;
+    static const int left_object = 0;
+    static const int right_object = 0;
+    return cgfs::PixelSample{right ? cgfs::RGB64F{200.0, 0.0, 0.0} : cgfs::RGB64F{0.0, 0.0, 0.0},
+                             right ? &right_object : &left_object};
+  };
+
+  SECTION("Only pixels along edges are supersampled") {
+    cgfs::ThreadPool pool{4};
+    RecordingCanvas canvas{66, 44};
+
+    const size_t samples = cgfs::render_adaptive(pool, canvas, sample_edge,
+                                                 cgfs::default_adaptive_sampling, 16);
+
+    // One sample per pixel plus the top up for the two columns beside the edge
+    const size_t pixels = 66 * 44;
+    const auto max_samples =
+        static_cast<size_t>(cgfs::default_adaptive_sampling.get<"max_samples">());
+    REQUIRE(samples == pixels + 2 * 44 * (max_samples - 1));
+
+    for (int32_t y{-22}; y < 22; ++y) {
+      for (int32_t x{-33}; x < 33; ++x) {
+        const auto red = canvas.reds[static_cast<size_t>((y + 22) * 66 + (x + 33))];
+        if (x < 4) { REQUIRE(red == 0); }
+        if (x > 4) { REQUIRE(red == 200); }
+        if (x == 4) {
+          // A quarter of the footprint is right of the edge, the pixel position itself is not
+          REQUIRE(red > 20);
+          REQUIRE(red < 80);
+        }
+      }
+    }
+  }
+
+  SECTION("Object-ID detection finds edges without contrast") {
+    cgfs::ThreadPool pool{2};
+    RecordingCanvas canvas{66, 44};
+
+    const auto same_color = [&](double x, double y) {
+      auto sample = sample_edge(x, y);
+      sample.get<"radiance">() = cgfs::RGB64F{50.0, 50.0, 50.0};
+      return sample;
+    };
+
+    const cgfs::AdaptiveSamplingSettings by_object{2, 8, 0.1, cgfs::EdgeDetection::object_id};
+    const cgfs::AdaptiveSamplingSettings by_contrast{2, 8, 0.1, cgfs::EdgeDetection::contrast};
+
+    REQUIRE(cgfs::render_adaptive(pool, canvas, same_color, by_object) ==
+            66 * 44 * 2 + 2 * 44 * 6);
+    REQUIRE(cgfs::render_adaptive(pool, canvas, same_color, by_contrast) == 66 * 44 * 2);
+  }
+
+  SECTION("Invalid sample counts are rejected") {
+    cgfs::ThreadPool pool{1};
+    RecordingCanvas canvas{4, 4};
+
+    REQUIRE_THROWS_AS(cgfs::render_adaptive(pool, canvas, sample_edge,
+                                            cgfs::AdaptiveSamplingSettings{
+                                                4, 2, 0.1, cgfs::EdgeDetection::contrast}),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("ThreadPool") {
+  SECTION("parallel_for visits every index") {
+    cgfs::ThreadPool pool{3};
+    std::vector<std::atomic<int>> visits(1000);
+
+    pool.parallel_for(visits.size(), [&](size_t i) { visits[i].fetch_add(1); });
+
+    for (const auto& visit : visits) { REQUIRE(visit.load() == 1); }
+  }
+
+  SECTION("Nested parallel_for completes") {
+    cgfs::ThreadPool pool{2};
+    std::atomic<int> total{0};
+
+    pool.parallel_for(8, [&](size_t) {
+      pool.parallel_for(8, [&](size_t) { total.fetch_add(1); });
+    });
+
+    REQUIRE(total.load() == 64);
+  }
+
+  SECTION("Exceptions are rethrown to the caller") {
+    cgfs::ThreadPool pool{2};
+
+    REQUIRE_THROWS_AS(pool.parallel_for(16,
+                                        [](size_t i) {
+                                          if (i == 5) { throw std::runtime_error("boom"); }
+                                        }),
+                      std::runtime_error);
+  }
+}
@@ -0,0 +1,93 @@
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/Render/IncrementalRenderer.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+#include "CGFS/Scene.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <vector>
+
+namespace {
+struct ImageCanvas : cgfs::DimensionsU32, cgfs::BBoxi32 {
+  ImageCanvas(int32_t width, int32_t height)
+      : cgfs::DimensionsU32{static_cast<uint32_t>(width), static_cast<uint32_t>(height)},
+        cgfs::BBoxi32{-width / 2, width / 2, -height / 2, height / 2},
+        pixels(static_cast<size_t>(width * height)) {}
+
+  using cgfs::BBoxi32::get;
+  using cgfs::DimensionsU32::get;
+
+  void put_pixel(int32_t x, int32_t y, cgfs::Color3 color) {
+    const auto width = static_cast<int32_t>(get<"width">());
+    pixels[static_cast<size_t>((y - get<"bottom">()) * width + (x - get<"left">()))] = color;
+  }
+
+  std::vector<cgfs::Color3> pixels;
+};
+
+cgfs::Scene<4, 3> make_scene() {
+  return cgfs::Scene<4, 3>{
+      std::array{cgfs::Sphere{cgfs::Vec3d{0.0, -1.0, 3.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{255, 0, 0}, 10.0, 0.3}},
+                 cgfs::Sphere{cgfs::Vec3d{-2.0, 0.0, 4.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{255, 255, 0}, 10.0, 0.3}},
+                 cgfs::Sphere{cgfs::Vec3d{2.0, 0.0, 4.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{0, 0, 255}, 10.0, 0.3}},
+                 cgfs::Sphere{cgfs::Vec3d{0.0, -5001.0, 0.0}, 5000.0,
+                              cgfs::MaterialProperties{cgfs::Color3{100, 100, 100}, 1.0, 0.1}}},
+      std::array{cgfs::Light{cgfs::AmbientLightProperties{0.2}},
+                 cgfs::Light{cgfs::PointLightProperties{0.6, cgfs::Vec3d{2.0, 1.0, 0.0}}},
+                 cgfs::Light{cgfs::DirectionalLightProperties{0.2, cgfs::Vec3d{1.0, 4.0, 4.0}}}},
+      cgfs::Color3{150, 175, 255}};
+}
+
+const cgfs::Camera camera{cgfs::Origin{0.0, 0.0, 0.0},
+                          cgfs::Mat3d{std::array{1.0, 0.0, 0.0}, std::array{0.0, 1.0, 0.0},
+                                      std::array{0.0, 0.0, 1.0}},
+                          cgfs::ProjectionPlane{1.0}};
+const cgfs::Viewport viewport{cgfs::DimensionsF64{1.0, 1.0}};
+const cgfs::TraceSettings settings{2, cgfs::default_min_contribution, false};
+}  // namespace
+
+TEST_CASE("IncrementalRenderer") {
+  cgfs::ThreadPool pool{2};
+
+  SECTION("Re-tracing dirty tiles matches a full render of the edited scene") {
+    const auto scene = make_scene();
+
+    auto compiled = cgfs::compile_scene(scene);
+    ImageCanvas canvas{192, 192};
+    cgfs::IncrementalRenderer renderer{pool, canvas, viewport, camera, settings, 16};
+    renderer.render(compiled);
+
+    for (const auto& [index, center] :
+         {std::pair{size_t{1}, cgfs::Vec3d{-2.2, 0.1, 4.0}},
+          std::pair{size_t{0}, cgfs::Vec3d{0.1, -1.0, 3.1}},
+          std::pair{size_t{2}, cgfs::Vec3d{2.5, 0.5, 6.0}}}) {
+      auto sphere = scene.get<"objects">()[index];
+      sphere.get<"center">() = center;
+
+      const auto retraced = renderer.update_sphere(compiled, index, sphere);
+      REQUIRE(retraced < renderer.tiles().size());
+
+      ImageCanvas expected{192, 192};
+      cgfs::IncrementalRenderer reference{pool, expected, viewport, camera, settings, 16};
+      reference.render(compiled);
+
+      REQUIRE(canvas.pixels == expected.pixels);
+    }
+  }
+
+  SECTION("Projection inverts primary ray generation") {
+    const ImageCanvas canvas{100, 80};
+    const cgfs::Vec3d on_ray = 3.5 * cgfs::canvas_to_viewport(cgfs::Vec2i32{17, -9}, viewport,
+                                                               canvas, camera);
+    const auto projected = cgfs::world_to_canvas(on_ray, viewport, canvas, camera);
+
+    REQUIRE(projected.has_value());
+    REQUIRE(projected->get<"x">() == Catch::Approx(17.0));
+    REQUIRE(projected->get<"y">() == Catch::Approx(-9.0));
+    REQUIRE_FALSE(cgfs::world_to_canvas(cgfs::Vec3d{0.0, 0.0, -1.0}, viewport, canvas, camera));
+  }
+}
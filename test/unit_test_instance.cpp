@@ -0,0 +1,190 @@
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Objects/Instance.hpp"
+#include "CGFS/Tracing/InstanceIntersection.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+const cgfs::MaterialProperties red{cgfs::Color3{255, 0, 0}, -1.0, 0.0};
+const cgfs::MaterialProperties green{cgfs::Color3{0, 255, 0}, -1.0, 0.0};
+
+cgfs::Mat3d diagonal(double x, double y, double z) {
+  return cgfs::Mat3d{std::array{x, 0.0, 0.0}, std::array{0.0, y, 0.0}, std::array{0.0, 0.0, z}};
+}
+
+// Rotation by angle around a unit axis, scaled uniformly
+cgfs::Mat3d rotation(const cgfs::Vec3d& axis, double angle, double scale) {
+  const double c = std::cos(angle);
+  const double s = std::sin(angle);
+  const double x = axis.get<"x">();
+  const double y = axis.get<"y">();
+  const double z = axis.get<"z">();
+  return cgfs::Mat3d{
+      std::array{scale * (c + x * x * (1 - c)), scale * (x * y * (1 - c) - z * s),
+                 scale * (x * z * (1 - c) + y * s)},
+      std::array{scale * (y * x * (1 - c) + z * s), scale * (c + y * y * (1 - c)),
+                 scale * (y * z * (1 - c) - x * s)},
+      std::array{scale * (z * x * (1 - c) - y * s), scale * (z * y * (1 - c) + x * s),
+                 scale * (c + z * z * (1 - c))}};
+}
+
+cgfs::InstanceGeometry unit_sphere() {
+  return cgfs::InstanceGeometry{{cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, 0.0}, 1.0, red}}};
+}
+
+cgfs::TriangleMesh tetrahedron() {
+  return cgfs::TriangleMesh{{cgfs::Vec3d{0.0, 0.0, 0.0}, cgfs::Vec3d{1.0, 0.0, 0.0},
+                             cgfs::Vec3d{0.0, 1.0, 0.0}, cgfs::Vec3d{0.0, 0.0, 1.0}},
+                            {0, 1, 2, 0, 1, 3, 0, 2, 3, 1, 2, 3},
+                            {0, 0, 0, 0},
+                            {green}};
+}
+}  // namespace
+
+TEST_CASE("Instances") {
+  const cgfs::Origin origin{0.0, 0.0, 0.0};
+
+  SECTION("Hits and normals follow the instance transform") {
+    const auto transform =
+        cgfs::make_transform(diagonal(1.0, 1.0, 3.0), cgfs::Vec3d{0.0, 0.0, 10.0});
+    const cgfs::InstanceSet set{{unit_sphere()},
+                                {cgfs::Instance{0, transform, cgfs::no_material_override}}};
+
+    const auto front = cgfs::closest_intersection(origin, cgfs::Vec3d{0.0, 0.0, 1.0}, 0.001,
+                                                  cgfs::basically_infinity, set);
+    REQUIRE(cgfs::is_hit(front));
+    REQUIRE(front.get<"closest_t">() == Catch::Approx(7.0));
+    REQUIRE(&cgfs::hit_material(front) == &set.geometries()[0].spheres()[0].get<"material">());
+    REQUIRE(cgfs::hit_normal(front, cgfs::Vec3d{}).get<"z">() == Catch::Approx(-1.0));
+
+    // Off axis the stretched sphere's normal is the inverse transpose of the object normal
+    const double h = std::sqrt(0.5);
+    const auto surface = cgfs::to_world_point(transform, cgfs::Vec3d{h, 0.0, h});
+    const auto normal = cgfs::to_world_normal(transform, cgfs::Vec3d{h, 0.0, h});
+    REQUIRE(normal.get<"z">() == Catch::Approx(normal.get<"x">() / 3.0));
+
+    const auto side = cgfs::closest_intersection(surface + 5.0 * normal, -normal, 0.001,
+                                                 cgfs::basically_infinity, set);
+    REQUIRE(side.get<"closest_t">() == Catch::Approx(5.0));
+    const auto side_normal = cgfs::hit_normal(side, surface);
+    REQUIRE(cgfs::dot(side_normal, normal) == Catch::Approx(1.0));
+  }
+
+  SECTION("Material overrides replace the geometry's materials") {
+    const cgfs::InstanceSet set{
+        {unit_sphere()},
+        {cgfs::Instance{0, cgfs::make_transform(cgfs::Vec3d{-2.0, 0.0, 10.0}),
+                        cgfs::no_material_override},
+         cgfs::Instance{0, cgfs::make_transform(cgfs::Vec3d{2.0, 0.0, 10.0}), 0}},
+        {green}};
+
+    const auto left = cgfs::closest_intersection(origin, cgfs::Vec3d{-0.2, 0.0, 1.0}, 0.001,
+                                                 cgfs::basically_infinity, set);
+    const auto right = cgfs::closest_intersection(origin, cgfs::Vec3d{0.2, 0.0, 1.0}, 0.001,
+                                                  cgfs::basically_infinity, set);
+    REQUIRE(cgfs::hit_material(left) == red);
+    REQUIRE(cgfs::hit_material(right) == green);
+    REQUIRE(set.geometries().size() == 1);
+  }
+
+  SECTION("The top level BVH matches testing every instance") {
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<double> position{-20.0, 20.0};
+    std::uniform_real_distribution<double> unit{-1.0, 1.0};
+    std::uniform_real_distribution<double> angle{0.0, 6.28};
+
+    std::vector<cgfs::Sphere> spheres;
+    for (int i = 0; i < 3; ++i) {
+      spheres.push_back(cgfs::Sphere{cgfs::Vec3d{unit(rng), unit(rng), unit(rng)}, 0.5, red});
+    }
+    std::vector<cgfs::InstanceGeometry> geometries;
+    geometries.emplace_back(spheres);
+    geometries.emplace_back(std::vector<cgfs::Sphere>{}, std::vector{tetrahedron()});
+
+    std::vector<cgfs::Instance> instances;
+    for (uint32_t i{0}; i < 300; ++i) {
+      cgfs::Vec3d axis{unit(rng), unit(rng), unit(rng)};
+      axis = axis / cgfs::length(axis);
+      instances.push_back(cgfs::Instance{
+          i % 2,
+          cgfs::make_transform(rotation(axis, angle(rng), 0.5 + (unit(rng) + 1.0)),
+                               cgfs::Vec3d{position(rng), position(rng), position(rng)}),
+          cgfs::no_material_override});
+    }
+    const cgfs::InstanceSet set{std::move(geometries), instances};
+    REQUIRE(set.instances().size() == 300);
+
+    for (int i = 0; i < 500; ++i) {
+      const cgfs::Origin ray_origin{position(rng), position(rng), position(rng)};
+      const cgfs::Vec3d direction{unit(rng), unit(rng), unit(rng)};
+
+      double linear_t = cgfs::basically_infinity;
+      for (const auto& instance : set.instances()) {
+        const auto& transform = instance.get<"transform">();
+        const auto hit = cgfs::closest_intersection(
+            cgfs::to_object_point(transform, ray_origin),
+            cgfs::to_object_direction(transform, direction), 0.001, cgfs::basically_infinity,
+            set.geometry_of(instance));
+        if (cgfs::is_hit(hit)) { linear_t = std::min(linear_t, hit.get<"closest_t">()); }
+      }
+
+      const auto hit = cgfs::closest_intersection(ray_origin, direction, 0.001,
+                                                  cgfs::basically_infinity, set);
+      REQUIRE(cgfs::is_hit(hit) == (linear_t < cgfs::basically_infinity));
+      REQUIRE(cgfs::occluded(ray_origin, direction, 0.001, cgfs::basically_infinity, set) ==
+              cgfs::is_hit(hit));
+      if (cgfs::is_hit(hit)) { REQUIRE(hit.get<"closest_t">() == Catch::Approx(linear_t)); }
+    }
+  }
+
+  SECTION("Instances trace and cast shadows through the scene queries") {
+    cgfs::DynamicScene scene{cgfs::Color3{0, 0, 0}};
+    scene.add_light(
+        cgfs::Light{cgfs::DirectionalLightProperties{1.0, cgfs::Vec3d{0.0, 0.0, -1.0}}});
+    const auto doubled = diagonal(2.0, 2.0, 2.0);
+    scene.add_shape(cgfs::InstanceSet{
+        {unit_sphere()},
+        {cgfs::Instance{0, cgfs::make_transform(doubled, cgfs::Vec3d{-3.0, 0.0, 10.0}),
+                        cgfs::no_material_override},
+         cgfs::Instance{0, cgfs::make_transform(doubled, cgfs::Vec3d{3.0, 0.0, 10.0}), 0},
+         cgfs::Instance{0, cgfs::make_transform(cgfs::Vec3d{3.0, 0.0, 5.0}), 0}},
+        {green}});
+    scene.add_shape(cgfs::Plane{cgfs::Vec3d{0.0, 0.0, 1.0}, 20.0, red});
+    const auto compiled = cgfs::compile_scene(cgfs::DynamicScene{scene});
+
+    const auto check = [&](const auto& traced) {
+      const auto trace = [&](const cgfs::Vec3d& direction) {
+        return cgfs::trace_ray(origin, direction, 0.001, cgfs::basically_infinity, 0, traced);
+      };
+      REQUIRE(trace(cgfs::Vec3d{-3.0, 0.0, 8.0}) == cgfs::Color3{255, 0, 0});
+      REQUIRE(trace(cgfs::Vec3d{3.0, 0.0, 4.0}) == cgfs::Color3{0, 255, 0});
+      // The plane behind the left instance is in its shadow
+      REQUIRE(trace(cgfs::Vec3d{-1.2, 0.0, 20.0}) == cgfs::Color3{0, 0, 0});
+      REQUIRE(trace(cgfs::Vec3d{0.0, 0.0, 1.0}) == cgfs::Color3{255, 0, 0});
+    };
+
+    check(scene);
+    check(compiled);
+  }
+
+  SECTION("Invalid instances are rejected") {
+    REQUIRE_THROWS_AS(cgfs::make_transform(diagonal(1.0, 0.0, 1.0), cgfs::Vec3d{}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        cgfs::InstanceSet({unit_sphere()},
+                          {cgfs::Instance{1, cgfs::make_transform(cgfs::Vec3d{}),
+                                          cgfs::no_material_override}}),
+        std::invalid_argument);
+    REQUIRE_THROWS_AS(
+        cgfs::InstanceSet({unit_sphere()},
+                          {cgfs::Instance{0, cgfs::make_transform(cgfs::Vec3d{}), 0}}),
+        std::invalid_argument);
+  }
+}
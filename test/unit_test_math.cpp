@@ -0,0 +1,36 @@
+#include "CGFS/Math.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+TEST_CASE("Math") {
+  SECTION("Helpers still evaluate at compile time") {
+    STATIC_REQUIRE(cgfs::sqrt(16.0) == 4.0);
+    STATIC_REQUIRE(cgfs::constexprPow(2.0, 10) == 1024.0);
+    STATIC_REQUIRE(cgfs::constexprPow(2.0, -2) == 0.25);
+    STATIC_REQUIRE(cgfs::length(cgfs::Vec3d{2.0, 3.0, 6.0}) == 7.0);
+    STATIC_REQUIRE(cgfs::dot(cgfs::Vec3d{1.0, 2.0, 3.0}, cgfs::Vec3d{4.0, 5.0, 6.0}) == 32.0);
+  }
+
+  SECTION("Runtime results match the standard library") {
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<double> value{0.0, 1000.0};
+    std::uniform_real_distribution<double> unit{0.0, 1.0};
+
+    for (int i = 0; i < 1000; ++i) {
+      const double x = value(rng);
+      REQUIRE(cgfs::sqrt(x) == std::sqrt(x));
+
+      const double base = unit(rng);
+      const double exponent = std::floor(value(rng));
+      REQUIRE(cgfs::constexprPow(base, exponent) == std::pow(base, exponent));
+      // Unlike the recursion, the runtime path takes fractional exponents
+      REQUIRE(cgfs::constexprPow(base, exponent + 0.5) == std::pow(base, exponent + 0.5));
+    }
+
+    REQUIRE_THROWS_AS(cgfs::sqrt(-1.0), std::runtime_error);
+  }
+}
@@ -0,0 +1,144 @@
+#include "CGFS/CompiledScene.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Objects/Mesh.hpp"
+#include "CGFS/Tracing/MeshIntersection.hpp"
+#include "CGFS/Tracing/ShapeIntersection.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+const cgfs::MaterialProperties red{cgfs::Color3{255, 0, 0}, -1.0, 0.0};
+const cgfs::MaterialProperties green{cgfs::Color3{0, 255, 0}, -1.0, 0.0};
+
+// A cells x cells grid of unit quads in the plane z = depth, two triangles per quad, with the
+// material alternating per triangle
+cgfs::TriangleMesh make_grid(int cells, double depth) {
+  cgfs::AlignedVector<cgfs::Vec3d> positions;
+  for (int y = 0; y <= cells; ++y) {
+    for (int x = 0; x <= cells; ++x) {
+      positions.emplace_back(static_cast<double>(x - cells / 2),
+                             static_cast<double>(y - cells / 2), depth);
+    }
+  }
+
+  cgfs::AlignedVector<uint32_t> indices;
+  cgfs::AlignedVector<uint32_t> face_materials;
+  const auto vertex = [&](int x, int y) { return static_cast<uint32_t>(y * (cells + 1) + x); };
+  for (int y = 0; y < cells; ++y) {
+    for (int x = 0; x < cells; ++x) {
+      indices.insert(indices.end(), {vertex(x, y), vertex(x + 1, y), vertex(x + 1, y + 1)});
+      indices.insert(indices.end(), {vertex(x, y), vertex(x + 1, y + 1), vertex(x, y + 1)});
+      face_materials.insert(face_materials.end(), {0, 1});
+    }
+  }
+
+  return cgfs::TriangleMesh{std::move(positions), std::move(indices), std::move(face_materials),
+                            {red, green}};
+}
+}  // namespace
+
+TEST_CASE("TriangleMesh") {
+  const cgfs::Origin origin{0.0, 0.0, 0.0};
+
+  SECTION("Rays through shared edges and vertices never slip between triangles") {
+    const auto mesh = make_grid(8, 4.0);
+
+    for (int y = -8; y <= 8; ++y) {
+      for (int x = -8; x <= 8; ++x) {
+        const cgfs::Vec3d direction{0.5 * x, 0.5 * y, 4.0};
+        const auto hit =
+            cgfs::closest_intersection(origin, direction, 0.001, cgfs::basically_infinity, mesh);
+        REQUIRE(cgfs::is_hit(hit));
+        REQUIRE(hit.get<"closest_t">() == Catch::Approx(1.0));
+        REQUIRE(cgfs::hit_normal(hit, direction) == cgfs::Vec3d{0.0, 0.0, -1.0});
+      }
+    }
+  }
+
+  SECTION("BVH queries match a linear scan over every face") {
+    std::mt19937 rng{3};
+    std::uniform_real_distribution<double> position{-10.0, 10.0};
+    std::uniform_real_distribution<double> offset{-1.0, 1.0};
+
+    cgfs::AlignedVector<cgfs::Vec3d> positions;
+    cgfs::AlignedVector<uint32_t> indices;
+    cgfs::AlignedVector<uint32_t> face_materials;
+    for (uint32_t face{0}; face < 500; ++face) {
+      const cgfs::Vec3d center{position(rng), position(rng), position(rng)};
+      for (int corner = 0; corner < 3; ++corner) {
+        positions.push_back(center + cgfs::Vec3d{offset(rng), offset(rng), offset(rng)});
+        indices.push_back(3 * face + static_cast<uint32_t>(corner));
+      }
+      face_materials.push_back(face % 2);
+    }
+    const cgfs::TriangleMesh mesh{positions, indices, face_materials, {red, green}};
+
+    for (int i = 0; i < 1000; ++i) {
+      const cgfs::Origin ray_origin{position(rng) * 2.0, position(rng) * 2.0, position(rng) * 2.0};
+      const cgfs::Vec3d direction{offset(rng), offset(rng), offset(rng)};
+
+      double linear_t = cgfs::basically_infinity;
+      cgfs::MaterialProperties const* linear_material = nullptr;
+      for (size_t face{0}; face < mesh.face_count(); ++face) {
+        const double t = cgfs::intersect_ray_triangle(
+            ray_origin, direction,
+            cgfs::Triangle{mesh.vertex(face, 0), mesh.vertex(face, 1), mesh.vertex(face, 2),
+                           red});
+        if (t > 0.001 && t < linear_t) {
+          linear_t = t;
+          linear_material = &mesh.face_material(face);
+        }
+      }
+
+      const auto hit = cgfs::closest_intersection(ray_origin, direction, 0.001,
+                                                  cgfs::basically_infinity, mesh);
+      REQUIRE(cgfs::is_hit(hit) == (linear_material != nullptr));
+      REQUIRE(cgfs::occluded(ray_origin, direction, 0.001, cgfs::basically_infinity, mesh) ==
+              (linear_material != nullptr));
+      if (linear_material != nullptr) {
+        REQUIRE(hit.get<"closest_t">() == Catch::Approx(linear_t));
+        REQUIRE(&cgfs::hit_material(hit) == linear_material);
+      }
+    }
+  }
+
+  SECTION("Invalid buffers are rejected") {
+    const cgfs::AlignedVector<cgfs::Vec3d> positions{cgfs::Vec3d{0.0, 0.0, 0.0},
+                                                     cgfs::Vec3d{1.0, 0.0, 0.0},
+                                                     cgfs::Vec3d{0.0, 1.0, 0.0}};
+
+    REQUIRE_THROWS_AS(cgfs::TriangleMesh(positions, {0, 1}, {}, {red}), std::invalid_argument);
+    REQUIRE_THROWS_AS(cgfs::TriangleMesh(positions, {0, 1, 3}, {0}, {red}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(cgfs::TriangleMesh(positions, {0, 1, 2}, {1}, {red}),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(cgfs::TriangleMesh(positions, {0, 1, 2}, {}, {red}), std::invalid_argument);
+  }
+
+  SECTION("Meshes trace and cast shadows through the scene queries") {
+    cgfs::DynamicScene scene{cgfs::Color3{0, 0, 0}};
+    scene.add_light(
+        cgfs::Light{cgfs::DirectionalLightProperties{1.0, cgfs::Vec3d{0.0, 1.0, -1.0}}});
+    scene.add_shape(make_grid(8, 10.0));
+    scene.add_object(cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, 7.0}, 0.5, red});
+    const auto compiled = cgfs::compile_scene(cgfs::DynamicScene{scene});
+
+    // Lit faces of both materials at 45 degrees, and a point in the sphere's shadow
+    const auto check = [&](const auto& traced) {
+      const auto trace = [&](const cgfs::Vec3d& point) {
+        return cgfs::trace_ray(origin, 0.5 * point, 1.0, cgfs::basically_infinity, 0, traced);
+      };
+      REQUIRE(trace(cgfs::Vec3d{-1.25, -1.75, 10.0}) == cgfs::Color3{180, 0, 0});
+      REQUIRE(trace(cgfs::Vec3d{-1.75, -1.25, 10.0}) == cgfs::Color3{0, 180, 0});
+      REQUIRE(trace(cgfs::Vec3d{0.1, -3.1, 10.0}) == cgfs::Color3{0, 0, 0});
+    };
+
+    check(scene);
+    check(compiled);
+  }
+}
@@ -0,0 +1,107 @@
+#include "CGFS/Loaders/ObjLoader.hpp"
+#include "CGFS/Render/ThreadPool.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+const cgfs::MaterialProperties red{cgfs::Color3{255, 0, 0}, -1.0, 0.0};
+const cgfs::MaterialProperties green{cgfs::Color3{0, 255, 0}, -1.0, 0.0};
+}  // namespace
+
+TEST_CASE("ObjLoader") {
+  cgfs::ThreadPool pool{4};
+
+  SECTION("Vertices, face corner forms, polygons and materials") {
+    const std::string text =
+        "# a quad and a triangle\n"
+        "mtllib scene.mtl\n"
+        "v 0 0 0\n"
+        "v 1.0 0.0 0.0\r\n"
+        "vt 0.5 0.5\n"
+        "vn 0 0 1\n"
+        "v 1 1 0 1.0\n"
+        "  v\t0 1 0\n"
+        "f 1/1 2/1/1 3//1 4\n"
+        "usemtl red\n"
+        "v 2 0 0\n"
+        "f -4 -3 -1\n"
+        "usemtl green\n"
+        "f 1 3 5\n"
+        "usemtl red\n"
+        "f 2 3 5\n";
+
+    const auto data = cgfs::parse_obj(text, pool);
+
+    REQUIRE(data.get<"positions">().size() == 5);
+    REQUIRE(data.get<"positions">()[1] == cgfs::Vec3d{1.0, 0.0, 0.0});
+    REQUIRE(data.get<"positions">()[3] == cgfs::Vec3d{0.0, 1.0, 0.0});
+    REQUIRE(data.get<"positions">()[4] == cgfs::Vec3d{2.0, 0.0, 0.0});
+
+    const std::vector<uint32_t> indices{data.get<"indices">().begin(),
+                                        data.get<"indices">().end()};
+    REQUIRE(indices == std::vector<uint32_t>{0, 1, 2, 0, 2, 3, 1, 2, 4, 0, 2, 4, 1, 2, 4});
+
+    const std::vector<uint32_t> materials{data.get<"face_materials">().begin(),
+                                          data.get<"face_materials">().end()};
+    REQUIRE(materials == std::vector<uint32_t>{0, 0, 1, 2, 1});
+    REQUIRE(data.get<"material_names">() == std::vector<std::string>{"", "red", "green"});
+  }
+
+  SECTION("Large files split across chunks parse in file order") {
+    // Each strip adds two vertices and a quad over the previous pair, with relative indices
+    std::string text = "v 0 0 0\nv 0 1 0\n";
+    const uint32_t strips = 20000;
+    for (uint32_t i{1}; i <= strips; ++i) {
+      text += "usemtl m" + std::to_string(i % 3) + "\n";
+      text += "v " + std::to_string(i) + " 0 0\nv " + std::to_string(i) + " 1 0\n";
+      text += "f -4 -2 -1 -3\n";
+    }
+    REQUIRE(text.size() > 8 * cgfs::min_obj_chunk_size);
+
+    const auto data = cgfs::parse_obj(text, pool);
+
+    REQUIRE(data.get<"positions">().size() == 2 * (strips + 1));
+    REQUIRE(data.get<"indices">().size() == 6 * strips);
+    REQUIRE(data.get<"material_names">() == std::vector<std::string>{"", "m1", "m2", "m0"});
+    for (uint32_t i{0}; i < strips; ++i) {
+      REQUIRE(data.get<"positions">()[2 * i + 2] == cgfs::Vec3d{i + 1.0, 0.0, 0.0});
+      REQUIRE(data.get<"indices">()[6 * i] == 2 * i);
+      REQUIRE(data.get<"indices">()[6 * i + 1] == 2 * i + 2);
+      REQUIRE(data.get<"indices">()[6 * i + 5] == 2 * i + 1);
+      REQUIRE(data.get<"face_materials">()[2 * i] == (i + 1) % 3 + ((i + 1) % 3 == 0 ? 3 : 0));
+    }
+  }
+
+  SECTION("Malformed lines throw") {
+    REQUIRE_THROWS_AS(cgfs::parse_obj("v 0 0\n", pool), std::runtime_error);
+    REQUIRE_THROWS_AS(cgfs::parse_obj("v 0 0 0\nv 1 0 0\nf 1 2\n", pool), std::runtime_error);
+    REQUIRE_THROWS_AS(cgfs::parse_obj("v 0 0 0\nf 1 0 1\n", pool), std::runtime_error);
+    REQUIRE_THROWS_AS(cgfs::parse_obj("v 0 0 0\nf -2 1 1\n", pool), std::runtime_error);
+    REQUIRE_THROWS_AS(cgfs::parse_obj("v 0 0 0\nf 1 a 1\n", pool), std::runtime_error);
+  }
+
+  SECTION("Files are mapped and become meshes") {
+    const auto path = std::filesystem::temp_directory_path() / "cgfs_unit_test_loader.obj";
+    {
+      std::ofstream file{path};
+      file << "v 0 0 0\nv 1 0 0\nv 0 1 0\nusemtl green\nf 1 2 3\n";
+    }
+
+    const auto mesh = cgfs::to_mesh(cgfs::load_obj(path, pool), [](std::string_view name) {
+      return name == "green" ? green : red;
+    });
+    std::filesystem::remove(path);
+
+    REQUIRE(mesh.face_count() == 1);
+    REQUIRE(mesh.vertex(0, 1) == cgfs::Vec3d{1.0, 0.0, 0.0});
+    REQUIRE(mesh.face_material(0) == green);
+    REQUIRE_THROWS_AS(cgfs::load_obj(path, pool), std::runtime_error);
+  }
+}
@@ -0,0 +1,539 @@
+#include "CGFS/CompiledSceneF.hpp"
+#include "CGFS/DynamicScene.hpp"
+#include "CGFS/Scene.hpp"
+#include "CGFS/Tracing/RayPacket.hpp"
+#include "CGFS/Tracing/Tracer.hpp"
+#include "CGFS/Tracing/Wavefront.hpp"
+
+#include <catch2/catch_all.hpp>
+
+#include <array>
+#include <cstdlib>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+// Two mirrors facing each other along z, lit only by ambient light so nothing saturates
+cgfs::Scene<2, 1> make_mirror_scene(double reflective) {
+  return cgfs::Scene<2, 1>{
+      std::array{cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, 5.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{200, 100, 50}, -1.0,
+                                                       reflective}},
+                 cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, -5.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{50, 100, 200}, -1.0,
+                                                       reflective}}},
+      std::array{cgfs::Light{cgfs::AmbientLightProperties{0.5}}}, cgfs::Color3{10, 20, 30}};
+}
+
+// Reflective spheres under every light type, so shadow and reflection queues are exercised
+cgfs::Scene<4, 3> make_lit_scene() {
+  return cgfs::Scene<4, 3>{
+      std::array{cgfs::Sphere{cgfs::Vec3d{0.0, -1.0, 3.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{255, 0, 0}, 500.0, 0.2}},
+                 cgfs::Sphere{cgfs::Vec3d{2.0, 0.0, 4.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{0, 0, 255}, 500.0, 0.3}},
+                 cgfs::Sphere{cgfs::Vec3d{-2.0, 0.0, 4.0}, 1.0,
+                              cgfs::MaterialProperties{cgfs::Color3{0, 255, 0}, 10.0, 0.4}},
+                 cgfs::Sphere{cgfs::Vec3d{0.0, -5001.0, 0.0}, 5000.0,
+                              cgfs::MaterialProperties{cgfs::Color3{255, 255, 0}, 1000.0, 0.5}}},
+      std::array{cgfs::Light{cgfs::AmbientLightProperties{0.2}},
+                 cgfs::Light{cgfs::PointLightProperties{0.6, cgfs::Vec3d{2.0, 1.0, 0.0}}},
+                 cgfs::Light{cgfs::DirectionalLightProperties{0.2, cgfs::Vec3d{1.0, 4.0, 4.0}}}},
+      cgfs::Color3{0, 0, 0}};
+}
+
+int channel_distance(const cgfs::Color3& lhs, const cgfs::Color3& rhs) {
+  return std::max({std::abs(lhs.get<"r">() - rhs.get<"r">()),
+                   std::abs(lhs.get<"g">() - rhs.get<"g">()),
+                   std::abs(lhs.get<"b">() - rhs.get<"b">())});
+}
+}  // namespace
+
+TEST_CASE("Tracer") {
+  const cgfs::Origin origin{0.0, 0.0, 0.0};
+
+  SECTION("Iterative tracer matches the recursive one up to per-level rounding") {
+    const auto scene = make_mirror_scene(0.5);
+    constexpr int depth = 6;
+
+    for (const auto& direction : {cgfs::Vec3d{0.0, 0.0, 1.0}, cgfs::Vec3d{0.05, 0.1, 1.0},
+                                  cgfs::Vec3d{-0.1, 0.02, -1.0}, cgfs::Vec3d{1.0, 0.0, 0.0}}) {
+      const auto recursive =
+          cgfs::trace_ray(origin, direction, 1.0, cgfs::basically_infinity, depth, scene);
+      const auto iterative =
+          cgfs::trace_ray_iterative(origin, direction, 1.0, cgfs::basically_infinity,
+                                    cgfs::TraceSettings{depth, 0.0, false}, scene);
+
+      // The recursive tracer truncates to 8 bit at every level, losing under one step each time
+      REQUIRE(channel_distance(recursive, iterative) <= depth + 1);
+    }
+  }
+
+  SECTION("Saturated highlights on mirrors are clamped per level like the recursive tracer") {
+    // Shiny, partly reflective spheres under a light bright enough to push the local color of
+    // a highlight well past 255 before the reflection blend
+    const cgfs::Scene<2, 2> scene{
+        std::array{cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, 3.0}, 1.0,
+                                cgfs::MaterialProperties{cgfs::Color3{255, 200, 100}, 50.0, 0.3}},
+                   cgfs::Sphere{cgfs::Vec3d{1.5, 0.5, 4.5}, 1.0,
+                                cgfs::MaterialProperties{cgfs::Color3{100, 255, 200}, 500.0, 0.5}}},
+        std::array{cgfs::Light{cgfs::AmbientLightProperties{0.4}},
+                   cgfs::Light{cgfs::PointLightProperties{2.0, cgfs::Vec3d{0.0, 2.0, 0.0}}}},
+        cgfs::Color3{10, 20, 30}};
+    constexpr int depth = 3;
+
+    int saturated = 0;
+    for (int y = -10; y <= 10; ++y) {
+      for (int x = -10; x <= 10; ++x) {
+        const cgfs::Vec3d direction{0.05 * x, 0.05 * y, 1.0};
+        const auto hit =
+            cgfs::closest_intersection(origin, direction, 1.0, cgfs::basically_infinity, scene);
+        if (cgfs::is_hit(hit)) {
+          const auto point = origin + (hit.get<"closest_t">() * direction);
+          const auto& material = cgfs::hit_material(hit);
+          saturated += cgfs::compute_lighting(point, cgfs::hit_normal(hit, point), -direction,
+                                              material.get<"specular">(), scene) > 1.5;
+        }
+
+        const auto recursive =
+            cgfs::trace_ray(origin, direction, 1.0, cgfs::basically_infinity, depth, scene);
+        const auto iterative =
+            cgfs::trace_ray_iterative(origin, direction, 1.0, cgfs::basically_infinity,
+                                      cgfs::TraceSettings{depth, 0.0, false}, scene);
+        REQUIRE(channel_distance(recursive, iterative) <= depth + 1);
+      }
+    }
+    REQUIRE(saturated > 0);
+  }
+
+  SECTION("Deep mirror chains need no call stack and the cutoff is invisible") {
+    const auto scene = make_mirror_scene(0.5);
+    const cgfs::Vec3d direction{0.0, 0.0, 1.0};
+
+    const auto exhaustive =
+        cgfs::trace_ray_iterative(origin, direction, 1.0, cgfs::basically_infinity,
+                                  cgfs::TraceSettings{1'000'000, 0.0, false}, scene);
+    const auto cut_off = cgfs::trace_ray_iterative(
+        origin, direction, 1.0, cgfs::basically_infinity,
+        cgfs::TraceSettings{1'000'000, cgfs::default_min_contribution, false}, scene);
+
+    REQUIRE(channel_distance(exhaustive, cut_off) <= 1);
+  }
+
+  SECTION("The shadow blocker cache is opt-in and never changes a result") {
+    const auto compiled = cgfs::compile_scene(make_lit_scene());
+    const cgfs::TraceSettings stateless{4, cgfs::default_min_contribution, false};
+    const cgfs::TraceSettings cached{4, cgfs::default_min_contribution, true};
+    auto& cache = cgfs::thread_shadow_cache();
+    cache.clear();
+
+    std::mt19937 rng{13};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    std::vector<cgfs::WavefrontRay> rays;
+    std::vector<cgfs::RGB64F> expected;
+    for (uint32_t i{0}; i < 500; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      rays.emplace_back(origin, direction, 1.0, i, 4, 1.0);
+      expected.push_back(cgfs::trace_radiance(
+          origin, direction,
+          cgfs::closest_intersection(origin, direction, 1.0, cgfs::basically_infinity, compiled),
+          stateless, compiled));
+    }
+    std::vector<cgfs::RGB64F> wavefront(rays.size(), cgfs::RGB64F{0.0, 0.0, 0.0});
+    auto wavefront_rays = rays;
+    cgfs::trace_wavefront(wavefront_rays, stateless, compiled, true, wavefront);
+    REQUIRE(wavefront == expected);
+    REQUIRE(cache.blocker(0) == cgfs::no_sphere);
+    REQUIRE(cache.blocker(1) == cgfs::no_sphere);
+
+    for (size_t i{0}; i < rays.size(); ++i) {
+      const auto& direction = rays[i].get<"direction">();
+      REQUIRE(cgfs::trace_radiance(origin, direction,
+                                   cgfs::closest_intersection(origin, direction, 1.0,
+                                                              cgfs::basically_infinity, compiled),
+                                   cached, compiled) == expected[i]);
+    }
+    std::fill(wavefront.begin(), wavefront.end(), cgfs::RGB64F{0.0, 0.0, 0.0});
+    cgfs::trace_wavefront(rays, cached, compiled, true, wavefront);
+    REQUIRE(wavefront == expected);
+    REQUIRE((cache.blocker(0) != cgfs::no_sphere || cache.blocker(1) != cgfs::no_sphere));
+    cache.clear();
+  }
+
+  SECTION("Wavefront tracing matches the per-ray tracer exactly, sorted or not") {
+    const auto scene = make_lit_scene();
+    const cgfs::TraceSettings settings{4, cgfs::default_min_contribution, false};
+
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    std::vector<cgfs::Vec3d> directions;
+    for (int i = 0; i < 500; ++i) {
+      directions.emplace_back(component(rng), component(rng), 1.0);
+    }
+
+    for (const bool sort_queues : {false, true}) {
+      std::vector<cgfs::WavefrontRay> rays;
+      for (const auto& direction : directions) {
+        rays.emplace_back(origin, direction, 1.0, static_cast<uint32_t>(rays.size()),
+                          settings.get<"max_depth">(), 1.0);
+      }
+
+      std::vector<cgfs::RGB64F> radiance(rays.size(), cgfs::RGB64F{0.0, 0.0, 0.0});
+      cgfs::trace_wavefront(rays, settings, scene, sort_queues, radiance);
+
+      for (size_t i{0}; i < directions.size(); ++i) {
+        const auto expected = cgfs::trace_radiance(
+            origin, directions[i],
+            cgfs::closest_intersection(origin, directions[i], 1.0, cgfs::basically_infinity,
+                                       scene),
+            settings, scene);
+        REQUIRE(radiance[i] == expected);
+      }
+    }
+  }
+}
+
+TEST_CASE("DynamicScene") {
+  const cgfs::Origin origin{0.0, 0.0, 0.0};
+  const auto scene = make_lit_scene();
+
+  SECTION("Traces exactly like the Scene it was built from, directly and compiled") {
+    const cgfs::DynamicScene dynamic{scene};
+    const auto compiled = cgfs::compile_scene(dynamic);
+
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    for (int i = 0; i < 500; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      const auto expected =
+          cgfs::trace_ray(origin, direction, 1.0, cgfs::basically_infinity, 3, scene);
+
+      REQUIRE(cgfs::trace_ray(origin, direction, 1.0, cgfs::basically_infinity, 3, dynamic) ==
+              expected);
+      REQUIRE(cgfs::trace_ray(origin, direction, 1.0, cgfs::basically_infinity, 3, compiled) ==
+              expected);
+    }
+  }
+
+  SECTION("Bulk inserts fill reserved storage, shrink_to_fit keeps the contents") {
+    cgfs::DynamicScene dynamic{cgfs::Color3{0, 0, 0}, 100, 4};
+    const auto* storage = dynamic.get<"objects">().data();
+
+    dynamic.insert_objects(scene.get<"objects">());
+    dynamic.insert_objects(scene.get<"objects">());
+    dynamic.insert_lights(scene.get<"lights">());
+
+    REQUIRE(dynamic.get<"objects">().size() == 8);
+    REQUIRE(dynamic.get<"lights">().size() == 3);
+    REQUIRE(dynamic.get<"objects">().data() == storage);
+
+    // shrink_to_fit is only a request, so check what it must keep rather than the capacity
+    dynamic.shrink_to_fit();
+    const auto& objects = scene.get<"objects">();
+    REQUIRE(dynamic.get<"objects">().size() == 2 * objects.size());
+    for (size_t i{0}; i < dynamic.get<"objects">().size(); ++i) {
+      REQUIRE(dynamic.get<"objects">()[i] == objects[i % objects.size()]);
+    }
+    REQUIRE(dynamic.get<"lights">().size() == scene.get<"lights">().size());
+  }
+}
+
+TEST_CASE("Shapes") {
+  const cgfs::Origin origin{0.0, 0.0, 0.0};
+  const cgfs::MaterialProperties matte{cgfs::Color3{200, 200, 200}, -1.0, 0.0};
+
+  SECTION("Each kernel finds its surface with a normal facing the ray") {
+    cgfs::ShapeArrays shapes{};
+    cgfs::add_shape(shapes, cgfs::Plane{cgfs::Vec3d{0.0, 1.0, 0.0}, -1.0, matte});
+    cgfs::add_shape(shapes, cgfs::Box{cgfs::Vec3d{-1.0, -1.0, 4.0}, cgfs::Vec3d{1.0, 1.0, 6.0},
+                                      matte});
+    cgfs::add_shape(shapes, cgfs::Disc{cgfs::Vec3d{5.0, 0.0, 0.0}, cgfs::Vec3d{1.0, 0.0, 0.0},
+                                       1.0, matte});
+    cgfs::add_shape(shapes, cgfs::Triangle{cgfs::Vec3d{-1.0, 0.0, -3.0},
+                                           cgfs::Vec3d{1.0, 0.0, -3.0},
+                                           cgfs::Vec3d{0.0, 2.0, -3.0}, matte});
+
+    const auto expect_hit = [&](const cgfs::Vec3d& direction, double t,
+                                const cgfs::Vec3d& normal) {
+      const auto hit =
+          cgfs::closest_intersection(origin, direction, 0.001, cgfs::basically_infinity, shapes);
+      REQUIRE(cgfs::is_hit(hit));
+      REQUIRE(hit.get<"closest_t">() == Catch::Approx(t));
+      REQUIRE(cgfs::hit_normal(hit, origin + t * direction) == normal);
+      REQUIRE(cgfs::occluded(origin, direction, 0.001, t + 0.01, shapes));
+      REQUIRE_FALSE(cgfs::occluded(origin, direction, 0.001, t - 0.01, shapes));
+    };
+
+    expect_hit(cgfs::Vec3d{0.0, -1.0, 0.0}, 1.0, cgfs::Vec3d{0.0, 1.0, 0.0});
+    expect_hit(cgfs::Vec3d{0.0, 0.0, 1.0}, 4.0, cgfs::Vec3d{0.0, 0.0, -1.0});
+    expect_hit(cgfs::Vec3d{1.0, 0.0, 0.0}, 5.0, cgfs::Vec3d{-1.0, 0.0, 0.0});
+    expect_hit(cgfs::Vec3d{0.0, 0.5, -1.0}, 3.0, cgfs::Vec3d{0.0, 0.0, 1.0});
+
+    const auto miss = cgfs::closest_intersection(origin, cgfs::Vec3d{0.0, 1.0, 0.0}, 0.001,
+                                                 cgfs::basically_infinity, shapes);
+    REQUIRE_FALSE(cgfs::is_hit(miss));
+  }
+
+  SECTION("Axis-aligned rays along a box face hit or miss by position, never by NaN") {
+    const cgfs::Box box{cgfs::Vec3d{-1.0, -1.0, 4.0}, cgfs::Vec3d{1.0, 1.0, 6.0}, matte};
+    const cgfs::Vec3d forward{0.0, 0.0, 1.0};
+
+    // Origins on the x = max and y = min slab planes, with no motion across them
+    REQUIRE(cgfs::intersect_ray_box(cgfs::Origin{1.0, 0.0, 0.0}, forward, 0.001, box) == 4.0);
+    REQUIRE(cgfs::intersect_ray_box(cgfs::Origin{-1.0, -1.0, 0.0}, forward, 0.001, box) == 4.0);
+    REQUIRE(cgfs::intersect_ray_box(cgfs::Origin{1.5, 0.0, 0.0}, forward, 0.001, box) ==
+            cgfs::basically_infinity);
+    REQUIRE(cgfs::intersect_ray_box(cgfs::Origin{0.0, 0.0, 5.0}, forward, 0.001, box) == 1.0);
+  }
+
+  SECTION("A ground plane stays exact at grazing angles and out of the BVH") {
+    cgfs::DynamicScene dynamic{cgfs::Color3{0, 0, 0}};
+    dynamic.add_object(cgfs::Sphere{cgfs::Vec3d{0.0, 0.0, 3.0}, 1.0, matte});
+    dynamic.add_shape(cgfs::Plane{cgfs::Vec3d{0.0, 1.0, 0.0}, -1.0, matte});
+    const auto compiled = cgfs::compile_scene(dynamic);
+
+    const auto& root = compiled.get<"bvh">().nodes().front().get<"bounds">();
+    REQUIRE(root.get<"min">().get<"y">() == -1.0);
+    REQUIRE(root.get<"max">().get<"y">() == 1.0);
+
+    for (const double slope : {1e-1, 1e-3, 1e-5}) {
+      const cgfs::Vec3d direction{1.0, -slope, 1.0};
+      const auto hit =
+          cgfs::closest_intersection(origin, direction, 1.0, cgfs::basically_infinity, compiled);
+      REQUIRE(cgfs::is_hit(hit));
+
+      const auto point = origin + hit.get<"closest_t">() * direction;
+      REQUIRE(point.get<"y">() == Catch::Approx(-1.0).epsilon(1e-12));
+    }
+  }
+
+  SECTION("Compiled, packet and wavefront tracing agree with the dynamic scene") {
+    cgfs::DynamicScene dynamic{make_lit_scene()};
+    dynamic.add_shape(cgfs::Plane{cgfs::Vec3d{0.0, 1.0, 0.0}, -1.5,
+                                  cgfs::MaterialProperties{cgfs::Color3{90, 90, 90}, 10.0, 0.3}});
+    dynamic.add_shape(cgfs::Box{cgfs::Vec3d{-0.5, 0.5, 2.5}, cgfs::Vec3d{0.5, 1.0, 3.0}, matte});
+    dynamic.add_shape(cgfs::Disc{cgfs::Vec3d{1.0, 1.0, 3.0}, cgfs::Vec3d{0.0, 0.0, 1.0}, 0.4,
+                                 matte});
+    dynamic.add_shape(cgfs::Triangle{cgfs::Vec3d{-2.0, 1.0, 3.0}, cgfs::Vec3d{-1.0, 1.0, 3.0},
+                                     cgfs::Vec3d{-1.5, 2.0, 3.5}, matte});
+    const auto compiled = cgfs::compile_scene(dynamic);
+    const cgfs::TraceSettings settings{3, cgfs::default_min_contribution, false};
+
+    std::mt19937 rng{17};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    cgfs::RayPacket<8> packet;
+    std::vector<cgfs::WavefrontRay> rays;
+    std::vector<cgfs::RGB64F> expected;
+    for (size_t i{0}; i < 400; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      const auto hit =
+          cgfs::closest_intersection(origin, direction, 1.0, cgfs::basically_infinity, dynamic);
+      const auto compiled_hit =
+          cgfs::closest_intersection(origin, direction, 1.0, cgfs::basically_infinity, compiled);
+
+      REQUIRE(cgfs::is_hit(hit) == cgfs::is_hit(compiled_hit));
+      if (cgfs::is_hit(hit)) {
+        REQUIRE(compiled_hit.get<"closest_t">() == Catch::Approx(hit.get<"closest_t">()));
+      }
+
+      // The compiled scene's sphere kernel rounds differently, so only the 8 bit colors must agree
+      expected.push_back(cgfs::trace_radiance(origin, direction, hit, settings, dynamic));
+      REQUIRE(channel_distance(cgfs::to_color3(cgfs::trace_radiance(origin, direction,
+                                                                    compiled_hit, settings,
+                                                                    compiled)),
+                               cgfs::to_color3(expected.back())) <= 1);
+      rays.emplace_back(origin, direction, 1.0, static_cast<uint32_t>(i), 3, 1.0);
+
+      packet.set_direction(i % packet.lanes, direction);
+      if (i % packet.lanes == packet.lanes - 1) {
+        const auto packet_hits =
+            cgfs::closest_intersection(packet, 1.0, cgfs::basically_infinity, compiled);
+        for (size_t lane{0}; lane < packet.lanes; ++lane) {
+          const auto lane_hit = cgfs::closest_intersection(
+              origin, packet.direction(lane), 1.0, cgfs::basically_infinity, compiled);
+          REQUIRE(cgfs::hit_object(packet_hits[lane]) == cgfs::hit_object(lane_hit));
+        }
+      }
+    }
+
+    std::vector<cgfs::RGB64F> radiance(rays.size(), cgfs::RGB64F{0.0, 0.0, 0.0});
+    cgfs::trace_wavefront(rays, settings, dynamic, true, radiance);
+    for (size_t i{0}; i < expected.size(); ++i) { REQUIRE(radiance[i] == expected[i]); }
+  }
+}
+
+TEST_CASE("PreparedLights") {
+  SECTION("Ambient lights fold into one term, the rest split by type in scene order") {
+    const std::array lights{
+        cgfs::Light{cgfs::AmbientLightProperties{0.125}},
+        cgfs::Light{cgfs::DirectionalLightProperties{0.3, cgfs::Vec3d{0.0, 3.0, 4.0}}},
+        cgfs::Light{cgfs::PointLightProperties{0.5, cgfs::Vec3d{1.0, 2.0, 3.0}}},
+        cgfs::Light{cgfs::AmbientLightProperties{0.25}},
+        cgfs::Light{cgfs::PointLightProperties{0.25, cgfs::Vec3d{-1.0, 0.0, 0.0}}}};
+
+    const auto prepared = cgfs::prepare_lights(lights);
+
+    REQUIRE(prepared.get<"ambient">() == 0.375);
+    REQUIRE(prepared.get<"point_lights">().size() == 2);
+    REQUIRE(prepared.get<"point_lights">()[1] == lights[4].point_light());
+    REQUIRE(prepared.get<"directional_lights">().size() == 1);
+    const auto& directional = prepared.get<"directional_lights">()[0];
+    REQUIRE(directional.get<"intensity">() == 0.3);
+    REQUIRE(directional.get<"direction">() == cgfs::Vec3d{0.0, 0.6, 0.8});
+    REQUIRE(directional.get<"shadow_direction">() == cgfs::Vec3d{0.0, 3.0, 4.0});
+  }
+
+  SECTION("Compiled scenes light points like their light list, up to rounding") {
+    const auto scene = make_lit_scene();
+    const auto compiled = cgfs::compile_scene(scene);
+
+    std::mt19937 rng{11};
+    std::uniform_real_distribution<double> component{-1.0, 1.0};
+    for (int i = 0; i < 500; ++i) {
+      const cgfs::Vec3d point{3.0 * component(rng), 2.0 * component(rng), 4.0 + component(rng)};
+      cgfs::Vec3d normal{component(rng), component(rng), component(rng)};
+      normal = normal / cgfs::length(normal);
+      const cgfs::Vec3d to_camera = -point;
+
+      // Folding the ambient terms and normalizing directional lights only changes rounding
+      for (const double specular : {-1.0, 10.0, 500.0}) {
+        REQUIRE(cgfs::compute_lighting(point, normal, to_camera, specular, compiled) ==
+                Catch::Approx(cgfs::compute_lighting(point, normal, to_camera, specular, scene))
+                    .epsilon(1e-12));
+      }
+    }
+  }
+
+  SECTION("Local lights only reach points within their radius") {
+    std::mt19937 rng{23};
+    std::uniform_real_distribution<double> position{-20.0, 20.0};
+    std::uniform_real_distribution<double> range{1.0, 8.0};
+
+    cgfs::DynamicScene scene{cgfs::Color3{0, 0, 0}};
+    scene.add_light(cgfs::Light{cgfs::AmbientLightProperties{0.1}});
+    std::vector<double> radii{cgfs::basically_infinity};
+    for (int i = 0; i < 200; ++i) {
+      scene.add_light(cgfs::Light{cgfs::PointLightProperties{
+          0.01, cgfs::Vec3d{position(rng), position(rng), position(rng)}}});
+      radii.push_back(i % 10 == 0 ? cgfs::basically_infinity : range(rng));
+    }
+    auto compiled = cgfs::compile_scene(cgfs::DynamicScene{scene});
+    cgfs::limit_light_influence(compiled, radii);
+
+    const auto& prepared = compiled.get<"prepared_lights">();
+    REQUIRE(prepared.get<"point_lights">().size() == 20);
+    REQUIRE(prepared.get<"local_lights">().size() == 180);
+
+    const auto& lights = scene.get<"lights">();
+    for (int i = 0; i < 200; ++i) {
+      const cgfs::Vec3d point{position(rng), position(rng), position(rng)};
+      cgfs::Vec3d normal{position(rng), position(rng), position(rng)};
+      normal = normal / cgfs::length(normal);
+      const cgfs::Vec3d to_camera = -point;
+
+      double expected = 0.1;
+      size_t expected_samples = 0;
+      for (size_t light{1}; light < lights.size(); ++light) {
+        const auto direction = lights[light].point_light().get<"position">() - point;
+        if (cgfs::length(direction) > radii[light]) { continue; }
+        expected += cgfs::diffuse_specular_intensity(normal, to_camera, 10.0, 0.01, direction);
+        ++expected_samples;
+      }
+
+      size_t samples = 0;
+      cgfs::for_each_light_sample(point, normal, to_camera, 10.0, prepared,
+                                  [&](uint32_t, const cgfs::Vec3d&, double, double) { ++samples; });
+      REQUIRE(samples == expected_samples);
+      REQUIRE(cgfs::compute_lighting(point, normal, to_camera, 10.0, compiled) ==
+              Catch::Approx(expected));
+    }
+
+    REQUIRE_THROWS_AS(cgfs::limit_light_influence(compiled, std::vector<double>{1.0}),
+                      std::invalid_argument);
+  }
+}
+
+TEST_CASE("Single precision") {
+  SECTION("Float renders stay within a step of double ones away from silhouettes") {
+    const auto compiled = cgfs::compile_scene(make_lit_scene());
+    const auto compiled_f = cgfs::to_single_precision(compiled);
+    const cgfs::TraceSettings settings{4, cgfs::default_min_contribution, false};
+
+    std::mt19937 rng{5};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    int far_off = 0;
+    constexpr int num_rays = 2000;
+    for (int i = 0; i < num_rays; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      const auto exact = cgfs::trace_ray_iterative(cgfs::Origin{0.0, 0.0, 0.0}, direction, 1.0,
+                                                   cgfs::basically_infinity, settings, compiled);
+      const auto single = cgfs::trace_ray_iterative(
+          cgfs::OriginF{0.0F, 0.0F, 0.0F}, cgfs::vec3_cast<float>(direction), 1.0F,
+          static_cast<float>(cgfs::basically_infinity), settings, compiled_f);
+      if (channel_distance(exact, single) > 1) { ++far_off; }
+    }
+
+    // Rays grazing an edge may land on either side of it, nothing else may move
+    REQUIRE(far_off < num_rays / 100);
+  }
+
+  SECTION("Cameras convert field by field") {
+    const cgfs::Camera camera{cgfs::Vec3d{1.0, 2.0, 3.0},
+                              cgfs::Mat3d{{{0.0, 0.0, 1.0}, {0.0, 1.0, 0.0}, {-1.0, 0.0, 0.0}}},
+                              cgfs::ProjectionPlane{1.5}};
+    const auto camera_f = cgfs::camera_cast<float>(camera);
+
+    REQUIRE(camera_f.get<"origin">() == cgfs::Vec3f{1.0F, 2.0F, 3.0F});
+    REQUIRE(camera_f.get<"rotation">()[2][0] == -1.0F);
+    REQUIRE(camera_f.get<"projection_plane">().get<"distance">() == 1.5F);
+    REQUIRE(cgfs::camera_cast<double>(camera_f) == camera);
+  }
+
+  SECTION("Shapes and local lights are traced in single precision too") {
+    const cgfs::MaterialProperties floor{cgfs::Color3{100, 100, 100}, 1.0, 0.1};
+    cgfs::DynamicScene scene{cgfs::Color3{0, 0, 0}};
+    scene.add_object(cgfs::Sphere{cgfs::Vec3d{0.0, -1.0, 3.0}, 1.0,
+                                  cgfs::MaterialProperties{cgfs::Color3{255, 0, 0}, 500.0, 0.2}});
+    scene.add_object(cgfs::Sphere{cgfs::Vec3d{-2.0, 0.0, 4.0}, 1.0,
+                                  cgfs::MaterialProperties{cgfs::Color3{0, 255, 0}, 10.0, 0.4}});
+    scene.add_shape(cgfs::Plane{cgfs::Vec3d{0.0, 1.0, 0.0}, -1.0, floor});
+    scene.add_shape(cgfs::Box{cgfs::Vec3d{1.0, -1.0, 3.0}, cgfs::Vec3d{2.0, 0.5, 4.0},
+                              cgfs::MaterialProperties{cgfs::Color3{0, 0, 255}, -1.0, 0.3}});
+    scene.add_light(cgfs::Light{cgfs::AmbientLightProperties{0.2}});
+    scene.add_light(cgfs::Light{cgfs::PointLightProperties{0.6, cgfs::Vec3d{2.0, 1.0, 0.0}}});
+    scene.add_light(cgfs::Light{cgfs::DirectionalLightProperties{0.2, cgfs::Vec3d{1.0, 4.0, 4.0}}});
+    scene.add_light(cgfs::Light{cgfs::PointLightProperties{0.4, cgfs::Vec3d{-1.0, 0.0, 1.5}}});
+
+    auto compiled = cgfs::compile_scene(cgfs::DynamicScene{scene});
+    cgfs::limit_light_influence(
+        compiled, std::vector<double>{cgfs::basically_infinity, cgfs::basically_infinity,
+                                      cgfs::basically_infinity, 2.5});
+    const auto compiled_f = cgfs::to_single_precision(compiled);
+    REQUIRE(compiled_f.get<"prepared_lights">().get<"local_lights">().size() == 1);
+
+    std::mt19937 rng{7};
+    std::uniform_real_distribution<double> component{-0.6, 0.6};
+
+    int far_off = 0;
+    constexpr int num_rays = 2000;
+    for (int i = 0; i < num_rays; ++i) {
+      const cgfs::Vec3d direction{component(rng), component(rng), 1.0};
+      const auto exact = cgfs::trace_ray_iterative(
+          cgfs::Origin{0.0, 0.0, 0.0}, direction, 1.0, cgfs::basically_infinity,
+          cgfs::TraceSettings{4, cgfs::default_min_contribution, false}, compiled);
+      const auto single = cgfs::trace_ray_iterative(
+          cgfs::OriginF{0.0F, 0.0F, 0.0F}, cgfs::vec3_cast<float>(direction), 1.0F,
+          static_cast<float>(cgfs::basically_infinity),
+          cgfs::TraceSettings{4, cgfs::default_min_contribution, true}, compiled_f);
+      if (channel_distance(exact, single) > 1) { ++far_off; }
+    }
+
+    REQUIRE(far_off < num_rays / 100);
+  }
+}